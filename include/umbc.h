@@ -4,11 +4,24 @@
 #define MSG_DELAY_MS 1000
 
 #ifdef __cplusplus
+#include "umbc/atomiccontrollerinput.hpp"
 #include "umbc/controller.hpp"
 #include "umbc/controllerinput.hpp"
 #include "umbc/controllerrecorder.hpp"
+#include "umbc/edgedetector.hpp"
+#include "umbc/inputformat.hpp"
+#include "umbc/looptiming.hpp"
+#include "umbc/menu.hpp"
 #include "umbc/pcontroller.hpp"
+#include "umbc/playlist.hpp"
+#include "umbc/posecorrection.hpp"
+#include "umbc/posetrack.hpp"
+#include "umbc/recording.hpp"
+#include "umbc/recordingcache.hpp"
+#include "umbc/recordingpath.hpp"
 #include "umbc/robot.hpp"
+#include "umbc/routinecatalog.hpp"
+#include "umbc/telemetry.hpp"
 #include "umbc/vcontroller.hpp"
 #include "umbc/log.hpp"
 #endif
@@ -0,0 +1,53 @@
+/**
+ * \file umbc/atomiccontrollerinput.hpp
+ *
+ * Contains the prototype for the AtomicControllerInput. AtomicControllerInput
+ * hands a whole ControllerInput from one task to others without a lock, so
+ * a reader never blocks and never sees half of an update.
+ */
+
+#ifndef _UMBC_ATOMIC_CONTROLLER_INPUT_HPP_
+#define _UMBC_ATOMIC_CONTROLLER_INPUT_HPP_
+
+#include "controllerinput.hpp"
+#include "api.h"
+
+#include <atomic>
+#include <cstdint>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class AtomicControllerInput {
+
+    private:
+    // the buttons and axes of a ControllerInput fit in 48 bits, so the whole
+    // frame is published with a single 64 bit store (ldrexd/strexd on the V5)
+    std::atomic<std::uint64_t> frame;
+
+    public:
+    /**
+     * Creates an atomic controller input with all inputs set to zero.
+     */
+    AtomicControllerInput();
+
+    /**
+     * Publishes a controller input. Any load after this returns either the
+     * previous or this controller input, never a mix of the two.
+     *
+     * \param controller_input
+     *      The controller input to publish.
+     */
+    void store(const ControllerInput& controller_input);
+
+    /**
+     * Gets the last published controller input. This never blocks.
+     *
+     * \return A copy of the last published controller input.
+     */
+    ControllerInput load() const;
+};
+}
+
+#endif // _UMBC_ATOMIC_CONTROLLER_INPUT_HPP_
@@ -9,6 +9,7 @@
 #ifndef _UMBC_CONTROLLER_HPP_
 #define _UMBC_CONTROLLER_HPP_
 
+#include "controllerinput.hpp"
 #include "api.h"
 
 #include <cstdint>
@@ -77,6 +78,17 @@ class Controller {
 	 */
 	virtual std::int32_t get_digital_new_press(pros::controller_digital_e_t button) = 0;
 
+	/**
+	 * Gets the state of every analog and digital channel in one call.
+	 *
+	 * Prefer this over polling each channel when more than a few channels
+	 * are read per loop, since it is a single virtual call.
+	 *
+	 * \return The current controller input. If the controller was not
+	 * connected, then every channel is 0
+	 */
+	virtual ControllerInput snapshot(void) = 0;
+
 	/**
 	 * Sets text to the controller LCD screen.
 	 *
@@ -23,24 +23,14 @@ typedef enum {
 
 class ControllerInput {
 
+    public:
+    static constexpr std::uint32_t number_of_digitals = 12;
+    static constexpr std::uint32_t number_of_analogs = 4;
+    static constexpr std::uint16_t digital_mask = (1 << number_of_digitals) - 1;
+
     private:
-    std::uint8_t digital_l1 : 1;
-    std::uint8_t digital_l2 : 1;
-    std::uint8_t digital_r1 : 1;
-    std::uint8_t digital_r2 : 1;
-    std::uint8_t digital_up : 1;
-    std::uint8_t digital_down : 1;
-    std::uint8_t digital_left : 1;
-    std::uint8_t digital_right : 1;
-    std::uint8_t digital_x : 1;
-    std::uint8_t digital_b : 1;
-    std::uint8_t digital_y : 1;
-    std::uint8_t digital_a : 1;
-
-    std::int8_t analog_left_x;
-    std::int8_t analog_left_y;
-    std::int8_t analog_right_x;
-    std::int8_t analog_right_y;
+    std::uint16_t digital;
+    std::int8_t analog[number_of_analogs];
 
     public:
     /**
@@ -48,6 +38,32 @@ class ControllerInput {
 	 */
     ControllerInput();
 
+    /**
+     * Creates a controller input object from a whole frame.
+     *
+     * \param buttons
+     *      The button bitmask, see buttons().
+     *
+     * \param axes
+     *      The analog values indexed by ANALOG_LEFT_X, ANALOG_LEFT_Y,
+     *      ANALOG_RIGHT_X, ANALOG_RIGHT_Y.
+     */
+    ControllerInput(std::uint16_t buttons, const std::int8_t axes[number_of_analogs]);
+
+    /**
+     * Gets the bit for a digital input in the button bitmask.
+     *
+     * \param button
+     *      The digital input. Must be one of
+     *      DIGITAL_{RIGHT,DOWN,LEFT,UP,A,B,Y,X,R1,R2,L1,L2}
+     *
+     * \return The bit index: L1 is 0 through A which is 11. Any other value
+     * is number_of_digitals or greater.
+     */
+    static constexpr std::uint32_t digital_index(controller_digital_e_t button) {
+        return (std::uint32_t)button - E_CONTROLLER_DIGITAL_L1;
+    }
+
     /**
 	 * Gets the value of an analog input (joystick).
 	 *
@@ -58,7 +74,7 @@ class ControllerInput {
 	 *
 	 * \return The value of the analog input: [-127, 127]
 	 */
-    std::int32_t get_analog(controller_analog_e_t channel);
+    std::int32_t get_analog(controller_analog_e_t channel) const;
 
     /**
 	 * Gets the value of a digital input (button).
@@ -69,7 +85,7 @@ class ControllerInput {
 	 *
 	 * \return The value of the digital input: 1 or 0
 	 */
-    std::int32_t get_digital(controller_digital_e_t button);
+    std::int32_t get_digital(controller_digital_e_t button) const;
 
     /**
 	 * Sets the value of an analog input (joystick).
@@ -99,6 +115,43 @@ class ControllerInput {
 	 */
     void set_digital(controller_digital_e_t button, std::int32_t value);
 
+    /**
+     * Gets all digital inputs as a bitmask, one bit per button at
+     * digital_index(button).
+     *
+     * \return The button bitmask.
+     */
+    std::uint16_t buttons() const;
+
+    /**
+     * Gets all analog inputs.
+     *
+     * \return The analog values indexed by ANALOG_LEFT_X, ANALOG_LEFT_Y,
+     * ANALOG_RIGHT_X, ANALOG_RIGHT_Y.
+     */
+    const std::int8_t* axes() const;
+
+    /**
+     * Sets every input at once.
+     *
+     * \param buttons
+     *      The button bitmask, see buttons(). Bits above number_of_digitals
+     *      are ignored.
+     *
+     * \param axes
+     *      The analog values indexed by ANALOG_LEFT_X, ANALOG_LEFT_Y,
+     *      ANALOG_RIGHT_X, ANALOG_RIGHT_Y. -128 is converted to -127.
+     */
+    void set_all(std::uint16_t buttons, const std::int8_t axes[number_of_analogs]);
+
+    /**
+     * Compares every input of two controller inputs.
+     *
+     * \return true if all digital and analog inputs are equal.
+     */
+    bool operator==(const ControllerInput& other) const;
+    bool operator!=(const ControllerInput& other) const;
+
 };
 }
 
@@ -11,10 +11,19 @@
 
 #include "controller.hpp"
 #include "controllerinput.hpp"
+#include "inputformat.hpp"
+#include "looptiming.hpp"
+#include "posetrack.hpp"
+#include "okapi/api/odometry/odometry.hpp"
 #include "api.h"
+#include "pros/apix.h"
 
+#include <atomic>
 #include <cstdint>
-#include <queue>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
 
 using namespace pros;
 using namespace std;
@@ -24,15 +33,46 @@ class ControllerRecorder {
 
     private:
     static constexpr char* t_record_controller_input_name =  (char*)"controllerrecorder";
+    static constexpr char* t_flush_controller_input_name =  (char*)"controllerrecorder_flush";
+    static constexpr std::uint32_t stream_block_size = 256;
+    static constexpr std::uint32_t close_timeout_ms = 2000;
 
     std::uint16_t poll_rate_ms;
+    controller_id_e_t controller_id;
+    input_encoding encoding;
+    std::uint8_t flags;
+    std::uint8_t analog_deadband;
     umbc::Controller* controller;
-    std::queue<ControllerInput> controller_input;
+    ControllerInput previous_controller_input;
+    std::stringstream controller_input;
+    std::int32_t max_jitter_ms;
+    std::uint32_t late_count;
+    LoopTiming loop_timing = LoopTiming(t_record_controller_input_name, 0);
+    okapi::Odometry* odometry;
+    std::uint32_t pose_capacity;
+    PoseTrack pose_track;
     std::unique_ptr<Task> t_record_controller_input;
 
+    std::string stream_file_path;
+    std::unique_ptr<std::ofstream> stream_file;
+    std::unique_ptr<InputEncoder> stream_encoder;
+    std::unique_ptr<ControllerInput[]> stream_blocks;
+    std::unique_ptr<std::int16_t[]> stream_jitter;
+    std::atomic<std::uint32_t> stream_block_full[2];
+    std::uint32_t stream_block;
+    std::uint32_t stream_block_index;
+    std::uint32_t stream_count;
+    std::uint32_t stream_overruns;
+    std::uint32_t stream_dropped;
+    std::int32_t stream_dropped_ms;
+    std::atomic<std::uint32_t> stream_failed;
+    std::atomic<std::uint32_t> stream_closing;
+    pros::c::sem_t stream_drained;
+    std::unique_ptr<Task> t_flush_controller_input;
+
     /**
-	 * Pushes current controller input to the controller input queue at the
-     * set poll rate.
+	 * Collects current controller input into the stream blocks at the set
+     * poll rate.
 	 * 
 	 * This function is intended to be used as a task, which is why it is
 	 * static.
@@ -47,6 +87,95 @@ class ControllerRecorder {
 	 */
 	static void record(void* ControllerRecorder);
 
+    /**
+     * Writes full stream blocks to the stream file, or encodes them into the
+     * controller input buffer when not streaming, as they are handed off by
+     * the record task.
+     * 
+     * This function is intended to be used as a task, which is why it is
+     * static.
+     * 
+     * \param ControllerRecorder
+     *          The controller recorder whose stream blocks will be written.
+     *          The type for this parameter must be ControllerRecorder.
+     *          Intended to be 'this' pointer.
+     */
+    static void flush(void* ControllerRecorder);
+
+    /**
+     * Appends a controller input to the current stream block. Once the block
+     * is full it is handed off to the flush task and recording continues in
+     * the other block.
+     *
+     * If the flush task has not emptied the other block yet, the controller
+     * input is dropped and counted instead of holding up the record task.
+     * The time of dropped controller inputs is added to the jitter of the
+     * next one kept, so with INPUT_FLAG_TIMESTAMPS the timeline still holds.
+     * 
+     * \param controller_input
+     *      The controller input to append.
+     * 
+     * \param jitter_ms
+     *      How many milliseconds more than the poll rate passed since the
+     *      previous controller input was sampled.
+     */
+    void stream(ControllerInput& controller_input, std::int16_t jitter_ms);
+
+    /**
+     * Clears the stream blocks and starts the flush task, stopping any flush
+     * task already running.
+     */
+    void open_blocks();
+
+    /**
+     * Waits for the flush task to write any full stream blocks, stops it,
+     * then writes the last partial block and finishes the encoder. The
+     * flush task signals once both blocks are written, and it is given at
+     * most close_timeout_ms, so a stuck SD card write cannot hang saving.
+     * 
+     * \return 1 on success, otherwise 0
+     */
+    std::int32_t close_blocks();
+
+    /**
+     * Stops the flush task if it is running.
+     */
+    void stop_flush();
+
+    /**
+     * Waits for the flush task to write any full stream blocks, writes the
+     * last partial block, and closes the stream file.
+     * 
+     * \return Number of controller inputs written to the stream file,
+     * otherwise -1 on failure.
+     */
+    std::int32_t close_stream();
+
+    /**
+     * Checks if controller input is being streamed to a file.
+     * 
+     * \return 1 if streaming, otherwise 0
+     */
+    std::int32_t isStreaming();
+
+    /**
+     * Logs how late the record task sampled controller input, then clears
+     * the statistics for the next recording. The loop timing is kept until
+     * recording starts again, see get_loop_timing.
+     */
+    void log_jitter();
+
+    /**
+     * Holds any analog axis that moved by no more than the analog deadband
+     * since the last recorded controller input at its last recorded value,
+     * so ADC noise does not count as a change. An axis returning to 0 is
+     * always recorded.
+     * 
+     * \param controller_input
+     *      The sampled controller input, updated in place.
+     */
+    void apply_deadband(ControllerInput& controller_input);
+
     public:
     /**
 	 * Creates a controller recorder object.
@@ -56,16 +185,70 @@ class ControllerRecorder {
      * 
      * \param poll_rate_ms
      *      The rate in milliseconds controller input will be polled at.
-     *           
+     * 
+     * \param controller_id
+     *      The id of the controller being recorded, stored in the file header.
+     * 
+     * \param encoding
+     *      How controller input is encoded in the saved file. Run-length
+     *      encoding is the smallest, packed frames can be indexed directly by
+     *      host tools.
+     * 
+     * \param flags
+     *      Any of input_flags. With INPUT_FLAG_TIMESTAMPS, how late each
+     *      controller input was sampled is saved so playback can follow the
+     *      recorded timeline. This costs nothing for samples taken on time.
+     * 
+     * \param analog_deadband
+     *      The largest change in an analog axis that is ignored, see
+     *      apply_deadband. With run-length encoding only changes take space,
+     *      so a small deadband keeps held inputs from being recorded as
+     *      noise.
 	 */
-    ControllerRecorder(umbc::Controller* controller, std::uint16_t poll_rate_ms);
+    ControllerRecorder(umbc::Controller* controller, std::uint16_t poll_rate_ms,
+        controller_id_e_t controller_id = E_CONTROLLER_MASTER, input_encoding encoding = INPUT_ENCODING_RLE,
+        std::uint8_t flags = INPUT_FLAG_TIMESTAMPS, std::uint8_t analog_deadband = 0);
+
+    /**
+     * Stops the record and flush tasks, which would otherwise keep running
+     * on a destroyed controller recorder. Controller input that was not
+     * saved is lost.
+     */
+    ~ControllerRecorder();
+
+    /**
+     * Records the pose of the robot with every controller input, so playback
+     * can correct drift towards the recorded path, see PoseCorrection. The
+     * pose track is saved next to the controller input file, see
+     * PoseTrack::path_for. The pose track is kept in memory until it is
+     * saved, also when streaming, which takes 6 bytes per controller input.
+     * Room for the whole run is reserved when recording starts, so the
+     * record loop does not reallocate the pose track.
+     * 
+     * \param odometry
+     *      The odometry of the robot, or nullptr to only record controller
+     *      input. It must be stepped by its own task and is only read here.
+     * 
+     * \param max_duration_ms
+     *      How long a run is expected to be recorded for. Poses past this
+     *      are still recorded, but may reallocate the pose track.
+     */
+    void set_odometry(okapi::Odometry* odometry, std::uint32_t max_duration_ms = 60000);
 
     /**
      * Saves the poll rate and recorded controller input into a binary file.
+     * Repeated frames are run-length encoded and analog values are delta
+     * encoded, and the header carries a CRC of the file, see InputEncoder.
      * 
      * This method is destructive and will clear all recorded controller
      * input.
      * 
+     * If recording was started with a stream file, the controller input is
+     * already on the SD card, so this only writes the last partial block and
+     * closes the stream file.
+     * 
+     * If poses were recorded, the pose track is saved next to the file.
+     * 
      * \param file_path
      *      The file path that the binary file will be created and saved at. If
      *      a file already exists at this location, it will be overwritten.
@@ -76,10 +259,26 @@ class ControllerRecorder {
     std::int32_t save(const char* file_path);
 
     /**
-     * Starts recording controller input.
+     * Starts recording controller input. Controller input is collected into
+     * the same fixed size blocks as when streaming, and full blocks are
+     * encoded into memory by the flush task, so the record task never
+     * allocates. With run-length encoding memory only grows when the
+     * controller input changes.
      */
 	void start(void);
 
+    /**
+     * Starts recording controller input and streams it to a file while
+     * recording. Controller input is collected into one of two fixed size
+     * blocks, and full blocks are written by a lower priority flush task, so
+     * memory use does not grow with the length of the recording.
+     * 
+     * \param file_path
+     *      The file path that the binary file will be created and streamed to.
+     *      If a file already exists at this location, it will be overwritten.
+     */
+    void start(const char* file_path);
+
     /**
      * Pauses recording controller input if controller recording is currently
      * active.
@@ -98,7 +297,7 @@ class ControllerRecorder {
 	void stop(void);
 
     /**
-     * Clears the controller input buffer.
+     * Clears the controller input buffer and the pose track.
      */
     void reset(void);
 
@@ -115,6 +314,14 @@ class ControllerRecorder {
      * \return 1 if there is controller input recorded, otherwise 0 
      */
     std::int32_t hasControllerInput();
+
+    /**
+     * Gets the timing of the record task's loop since recording last
+     * started.
+     * 
+     * \return The loop timing.
+     */
+    LoopTiming& get_loop_timing();
 };
 }
 
@@ -0,0 +1,83 @@
+/**
+ * \file umbc/edgedetector.hpp
+ *
+ * Contains the prototype for the EdgeDetector. The EdgeDetector latches
+ * rising edges (new presses) for all controller buttons at once from a
+ * button bitmask, see ControllerInput::buttons.
+ */
+
+#ifndef _UMBC_EDGE_DETECTOR_HPP_
+#define _UMBC_EDGE_DETECTOR_HPP_
+
+#include "controllerinput.hpp"
+#include "api.h"
+
+#include <atomic>
+#include <cstdint>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class EdgeDetector {
+
+    private:
+    std::uint16_t current;
+    std::atomic<std::uint16_t> new_presses;
+
+    public:
+    /**
+     * Creates an edge detector with no buttons held or pressed.
+     */
+    EdgeDetector();
+
+    /**
+     * Updates the held buttons and latches any button that was not held
+     * before as a new press. A latched new press stays set until it is
+     * read, even if the button is released.
+     *
+     * Only one task should call this function.
+     *
+     * \param buttons
+     *      The currently held buttons, one bit per button as in
+     *      ControllerInput::buttons.
+     */
+    void update(std::uint16_t buttons);
+
+    /**
+     * Clears the held buttons and all latched new presses.
+     */
+    void reset();
+
+    /**
+     * Gets the currently held buttons.
+     *
+     * \return The held buttons as of the last update.
+     */
+    std::uint16_t get();
+
+    /**
+     * Returns a rising-edge case for a button and clears its latched new
+     * press. Clearing one button does not affect the others, and is safe to
+     * do while another task calls update.
+     *
+     * \param button
+     *      The button to read. Must be one of
+     *      DIGITAL_{RIGHT,DOWN,LEFT,UP,A,B,Y,X,R1,R2,L1,L2}
+     *
+     * \return 1 if the button was newly pressed since the last time this
+     * function was called for it, 0 otherwise.
+     */
+    std::int32_t get_new_press(controller_digital_e_t button);
+
+    /**
+     * Returns and clears the latched new presses for every button.
+     *
+     * \return The newly pressed buttons, one bit per button as in
+     * ControllerInput::buttons.
+     */
+    std::uint16_t get_new_presses();
+};
+}
+
+#endif // _UMBC_EDGE_DETECTOR_HPP_
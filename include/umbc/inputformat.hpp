@@ -0,0 +1,309 @@
+/**
+ * \file umbc/inputformat.hpp
+ *
+ * Contains the prototypes for the InputEncoder and InputDecoder. These
+ * classes read and write the binary controller input files created by the
+ * ControllerRecorder and played back by the VController.
+ *
+ * A versioned file starts with a zero poll rate, which is illegal in the
+ * legacy format, followed by the magic "UMBC" and the version. All
+ * multi-byte values are little-endian. The version 3 header is:
+ *
+ *   0  uint16_t  0
+ *   2  char[4]   "UMBC"
+ *   6  uint8_t   version
+ *   7  uint8_t   encoding, see input_encoding
+ *   8  uint16_t  poll rate in milliseconds
+ *  10  uint8_t   controller id
+ *  11  uint8_t   flags, see input_flags
+ *  12  uint32_t  number of frames
+ *  16  uint32_t  CRC32 of the body followed by header bytes 0 - 15
+ *  20            body
+ *
+ * A packed frame is 6 bytes: a uint16_t with one bit per button, in the
+ * order L1, L2, R1, R2, UP, DOWN, LEFT, RIGHT, X, B, Y, A starting from bit
+ * 0, followed by the int8_t left x, left y, right x and right y axes.
+ *
+ * A packed body is an array of packed frames. If the file has timestamps,
+ * each packed frame is followed by its int16_t jitter. A run-length encoded
+ * body is a stream of records:
+ *
+ *  0x00 - 0x7F  Repeat the previous frame (tag + 1) times.
+ *  0x80 - 0xFF  New frame. Bit 4 is set if the buttons changed, in which
+ *               case a uint16_t button mask follows. Bits 0 - 3 mark which
+ *               analog axes changed (left x, left y, right x, right y).
+ *               Bit 6 is set if every changed axis delta fits in a nibble,
+ *               in which case the deltas are packed two per byte, otherwise
+ *               each delta takes one byte. Bit 5 is set if the frame has
+ *               a non-zero jitter, which follows as a zigzag varint.
+ *
+ * The jitter of a frame is how many milliseconds more than the poll rate
+ * passed since the previous frame was sampled, and is only stored if the
+ * file has timestamps. Repeated frames always have a jitter of 0.
+ *
+ * Version 2 files have a 9 byte header (zero, magic, version, poll rate)
+ * followed by a run-length encoded body.
+ */
+
+#ifndef _UMBC_INPUT_FORMAT_HPP_
+#define _UMBC_INPUT_FORMAT_HPP_
+
+#include "controllerinput.hpp"
+#include "api.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+typedef enum {
+    INPUT_FORMAT_LEGACY = 1,
+    INPUT_FORMAT_RLE = 2,
+    INPUT_FORMAT_CRC = 3,
+    INPUT_FORMAT_LATEST = INPUT_FORMAT_CRC
+} input_format_version;
+
+typedef enum {
+    INPUT_ENCODING_PACKED = 0,
+    INPUT_ENCODING_RLE = 1
+} input_encoding;
+
+typedef enum {
+    INPUT_FLAG_TIMESTAMPS = 0x01
+} input_flags;
+
+class InputEncoder {
+
+    public:
+    static constexpr std::uint32_t header_size = 20;
+    static constexpr std::uint32_t packed_frame_size = 6;
+
+    private:
+    static constexpr std::uint8_t max_run_length = 0x80;
+
+    std::ostream& out;
+    input_encoding encoding;
+    std::uint8_t flags;
+    std::streampos header_position;
+    std::uint8_t header[header_size];
+    ControllerInput previous;
+    std::uint32_t run_length;
+    std::uint32_t number_of_frames;
+    std::uint32_t crc;
+
+    /**
+     * Writes bytes to the body and adds them to the CRC.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t write(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Writes the pending run of repeated frames.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t write_run();
+
+    public:
+    /**
+     * Creates an encoder that writes to the given stream.
+     *
+     * \param out
+     *      The binary stream the encoded controller input is written to. The
+     *      stream must be seekable, since the frame count and CRC in the
+     *      header are written by finish.
+     *
+     * \param encoding
+     *      How the body is encoded. Run-length encoding is the smallest,
+     *      packed frames can be indexed directly by host tools.
+     */
+    InputEncoder(std::ostream& out, input_encoding encoding = INPUT_ENCODING_RLE);
+
+    /**
+     * Writes the file header. The frame count and CRC are left as zero until
+     * finish is called.
+     *
+     * \param poll_rate_ms
+     *      The rate in milliseconds the controller input was polled at.
+     *
+     * \param controller_id
+     *      The controller the input was recorded from.
+     *
+     * \param flags
+     *      Any of input_flags, e.g. INPUT_FLAG_TIMESTAMPS to store the jitter
+     *      of each frame.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t write_header(std::uint16_t poll_rate_ms, controller_id_e_t controller_id, std::uint8_t flags = 0);
+
+    /**
+     * Encodes the next controller input. With run-length encoding, frames
+     * identical to the previous frame are held back and written as a single
+     * run.
+     *
+     * \param controller_input
+     *      The next controller input to encode.
+     *
+     * \param jitter_ms
+     *      How many milliseconds more than the poll rate passed since the
+     *      previous controller input was sampled. Ignored unless the header
+     *      was written with INPUT_FLAG_TIMESTAMPS.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t push(const ControllerInput& controller_input, std::int16_t jitter_ms = 0);
+
+    /**
+     * Writes any pending run, then seeks back and fills in the frame count
+     * and CRC in the header. Must be called once all controller input has
+     * been pushed.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t finish();
+};
+
+class InputDecoder {
+
+    private:
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t offset;
+    std::int32_t version;
+    input_encoding encoding;
+    std::uint8_t controller_id;
+    std::uint8_t flags;
+    std::uint32_t number_of_frames;
+    std::uint32_t number_of_frames_decoded;
+    ControllerInput previous;
+    std::uint32_t run_remaining;
+
+    /**
+     * Decodes the next run-length encoded record.
+     *
+     * \return 1 if a controller input was decoded, 0 at the end of the
+     * stream, otherwise -1 on a malformed or truncated stream.
+     */
+    std::int32_t next_rle(ControllerInput& controller_input, std::int16_t& jitter_ms);
+
+    /**
+     * Reads the file header, see read_header and peek_header.
+     *
+     * \param poll_rate_ms
+     *      Set to the poll rate stored in the header.
+     *
+     * \param check_crc
+     *      1 to reject version 3 files whose CRC does not match, which needs
+     *      the whole file in the buffer.
+     *
+     * \return The file format version on success, otherwise 0.
+     */
+    std::int32_t parse_header(std::uint16_t& poll_rate_ms, std::int32_t check_crc);
+
+    public:
+    /**
+     * Creates a decoder that reads from a buffer holding an entire
+     * controller input file. The buffer is not copied and must outlive the
+     * decoder.
+     *
+     * \param data
+     *      The contents of the controller input file.
+     *
+     * \param size
+     *      The size of the buffer in bytes.
+     */
+    InputDecoder(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Reads the file header. Versioned and legacy headers are accepted. For
+     * version 3 files the CRC is checked here, so a corrupt file is rejected
+     * before any controller input is decoded.
+     *
+     * \param poll_rate_ms
+     *      Set to the poll rate stored in the header.
+     *
+     * \return The file format version on success, otherwise 0.
+     */
+    std::int32_t read_header(std::uint16_t& poll_rate_ms);
+
+    /**
+     * Reads the file header without checking the CRC, so the buffer only
+     * needs to hold the first InputEncoder::header_size bytes of the file.
+     * Used to list files without reading them in full.
+     *
+     * \param poll_rate_ms
+     *      Set to the poll rate stored in the header.
+     *
+     * \return The file format version on success, otherwise 0.
+     */
+    std::int32_t peek_header(std::uint16_t& poll_rate_ms);
+
+    /**
+     * Gets the number of frames stored in the header. Files older than
+     * version 3 do not store this, see count.
+     *
+     * \return The number of frames from the header, or 0 if not stored.
+     */
+    std::uint32_t get_number_of_frames();
+
+    /**
+     * Gets the controller the input was recorded from. Files older than
+     * version 3 do not store this and are assumed to be from the master
+     * controller.
+     *
+     * \return The controller id from the header.
+     */
+    controller_id_e_t get_controller_id();
+
+    /**
+     * Checks if the file stores the jitter of each frame.
+     *
+     * \return 1 if the file has timestamps, otherwise 0
+     */
+    std::int32_t has_timestamps();
+
+    /**
+     * Decodes the next controller input.
+     *
+     * \param controller_input
+     *      Set to the next controller input.
+     *
+     * \return 1 if a controller input was decoded, 0 at the end of the
+     * stream, otherwise -1 on a malformed or truncated stream.
+     */
+    std::int32_t next(ControllerInput& controller_input);
+
+    /**
+     * Decodes the next controller input and its jitter.
+     *
+     * \param controller_input
+     *      Set to the next controller input.
+     *
+     * \param jitter_ms
+     *      Set to how many milliseconds more than the poll rate passed since
+     *      the previous controller input was sampled, 0 if the file has no
+     *      timestamps.
+     *
+     * \return 1 if a controller input was decoded, 0 at the end of the
+     * stream, otherwise -1 on a malformed or truncated stream.
+     */
+    std::int32_t next(ControllerInput& controller_input, std::int16_t& jitter_ms);
+
+    /**
+     * Counts the controller inputs remaining in the buffer without
+     * consuming them. Used to size the playback buffer before decoding.
+     * Version 3 files store the count in the header, so this is O(1).
+     *
+     * \return The number of controller inputs remaining, otherwise -1 on a
+     * malformed or truncated stream.
+     */
+    std::int32_t count();
+};
+}
+
+#endif // _UMBC_INPUT_FORMAT_HPP_
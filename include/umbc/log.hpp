@@ -3,24 +3,327 @@
  *
  * Contains definitions for logging to the pros terminal. To disable
  * commenting, ensure LOG is not defined.
+ *
+ * The DEBUG, INFO, WARN and ERROR macros take a printf style format and its
+ * arguments. The calling task only copies the format pointer and the
+ * arguments into a ring buffer, the text is formatted and written to the
+ * terminal or the SD card by a low priority drain task, see Log.
+ *
+ * Messages below the level of their module are removed at compile time,
+ * arguments included. A source file picks its module by defining LOG_MODULE
+ * before including umbc.h, otherwise it logs as LOG_MODULE_USER. Build with
+ * e.g. -DLOG_LEVEL=LOG_LEVEL_WARN for competition, or
+ * -DLOG_LEVEL=LOG_LEVEL_DEBUG to debug.
  */
 
 #ifndef _UMBC_LOG_HPP_
 #define _UMBC_LOG_HPP_
 
-#include <iostream>
+#include "api.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
 
 #define LOG // comment out this line to disable logging
 
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_USER
+#endif
+
 #ifdef LOG
-#define INFO(str) cout << "INFO: " << str << endl;
-#define WARN(str) cout << "WARN: " << str << endl;
-#define ERROR(str) cerr << "ERROR: " << str << endl;
+#define LOG_WRITE(level, ...) \
+    do { \
+        if constexpr (umbc::log_is_enabled(umbc::LOG_MODULE, level)) { \
+            umbc::Log::write(umbc::LOG_MODULE, level, __VA_ARGS__); \
+        } \
+    } while (0);
+
+#define DEBUG(...) LOG_WRITE(umbc::LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define INFO(...) LOG_WRITE(umbc::LOG_LEVEL_INFO, __VA_ARGS__)
+#define WARN(...) LOG_WRITE(umbc::LOG_LEVEL_WARN, __VA_ARGS__)
+#define ERROR(...) LOG_WRITE(umbc::LOG_LEVEL_ERROR, __VA_ARGS__)
 
 #else
-#define INFO(str)
-#define WARN(str)
-#define ERROR(str)
+#define DEBUG(...)
+#define INFO(...)
+#define WARN(...)
+#define ERROR(...)
 #endif
 
-#endif // _UMBC_LOG_HPP_
\ No newline at end of file
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+typedef enum {
+    LOG_LEVEL_DEBUG = 0,
+    LOG_LEVEL_INFO = 1,
+    LOG_LEVEL_WARN = 2,
+    LOG_LEVEL_ERROR = 3,
+    LOG_LEVEL_NONE = 4
+} log_level;
+
+typedef enum {
+    LOG_MODULE_USER = 0,
+    LOG_MODULE_ROBOT = 1,
+    LOG_MODULE_RECORDER = 2,
+    LOG_MODULE_PLAYBACK = 3,
+    LOG_MODULE_RECORDING = 4,
+    LOG_MODULE_POSE = 5,
+    LOG_MODULE_TIMING = 6,
+    LOG_MODULE_LOG = 7,
+    LOG_MODULE_TELEMETRY = 8,
+    LOG_MODULE_COUNT = 9
+} log_module;
+
+/**
+ * The lowest level each module logs, in the order of log_module, on top of
+ * LOG_LEVEL. Raise a module to quiet it, e.g. LOG_LEVEL_NONE.
+ */
+inline constexpr log_level log_module_levels[LOG_MODULE_COUNT] = {
+    LOG_LEVEL_DEBUG, // user
+    LOG_LEVEL_DEBUG, // robot
+    LOG_LEVEL_DEBUG, // recorder
+    LOG_LEVEL_DEBUG, // playback
+    LOG_LEVEL_DEBUG, // recording
+    LOG_LEVEL_DEBUG, // pose
+    LOG_LEVEL_DEBUG, // timing
+    LOG_LEVEL_DEBUG, // log
+    LOG_LEVEL_DEBUG  // telemetry
+};
+
+/**
+ * Checks at compile time whether a module logs at a level.
+ *
+ * \param module
+ *      The module logging.
+ *
+ * \param level
+ *      The level of the message.
+ *
+ * \return True if the message is logged, false if it is compiled out.
+ */
+constexpr bool log_is_enabled(log_module module, log_level level) {
+    return LOG_LEVEL <= level && log_module_levels[module] <= level && LOG_LEVEL_NONE != level;
+}
+
+class Log {
+
+    private:
+    static constexpr char* t_drain_name = (char*)"log_drain";
+    static constexpr std::uint32_t number_of_entries = 128;
+    static constexpr std::uint32_t payload_size = 128;
+    static constexpr std::uint32_t drain_delay_ms = 10;
+    static constexpr std::uint32_t task_name_size = TASK_NAME_MAX_LEN;
+
+    typedef enum {
+        ARGUMENT_SIGNED = 0,
+        ARGUMENT_UNSIGNED = 1,
+        ARGUMENT_DOUBLE = 2,
+        ARGUMENT_STRING = 3
+    } argument_type;
+
+    struct Entry {
+        std::atomic<std::uint32_t> sequence;
+        const char* format;
+        std::uint32_t time_ms;
+        std::uint8_t module;
+        std::uint8_t level;
+        std::uint8_t size;
+        std::uint8_t truncated;
+        char task[task_name_size];
+        std::uint8_t payload[payload_size];
+    };
+
+    static Entry entries[number_of_entries];
+    static std::atomic<std::uint32_t> enqueue_position;
+    static std::atomic<std::uint32_t> dequeue_position;
+    static std::atomic<std::uint32_t> dropped;
+    static std::atomic<std::uint32_t> stopping;
+    static std::string file_path;
+    static std::unique_ptr<Task> t_drain;
+
+    /**
+     * Claims the next free entry of the ring buffer and stamps it with the
+     * time and the name of the calling task.
+     *
+     * \param module
+     *      The module logging.
+     *
+     * \param level
+     *      The level of the message.
+     *
+     * \param format
+     *      The printf style format of the message.
+     *
+     * \return The entry, or nullptr if the ring buffer is full.
+     */
+    static Entry* reserve(log_module module, log_level level, const char* format);
+
+    /**
+     * Hands a claimed entry to the drain task.
+     *
+     * \param entry
+     *      The entry, from reserve.
+     */
+    static void commit(Entry* entry);
+
+    /**
+     * Copies an argument into the payload of an entry, tagged with its
+     * type. Strings are copied, so they may be freed as soon as write
+     * returns. An argument that does not fit marks the entry as truncated.
+     *
+     * \param entry
+     *      The entry being written.
+     *
+     * \param type
+     *      The type of the argument.
+     *
+     * \param data
+     *      The argument, 8 bytes for numbers.
+     *
+     * \param size
+     *      The number of bytes in data.
+     */
+    static void pack(Entry* entry, argument_type type, const void* data, std::uint32_t size);
+
+    template <typename T> static void pack_argument(Entry* entry, const T& argument) {
+
+        if constexpr (std::is_same_v<T, std::string>) {
+            pack(entry, ARGUMENT_STRING, argument.data(), argument.size());
+        } else if constexpr (std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>) {
+            pack(entry, ARGUMENT_STRING, argument, (nullptr == argument) ? 0 : std::strlen(argument));
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double value = argument;
+            pack(entry, ARGUMENT_DOUBLE, &value, sizeof(value));
+        } else if constexpr (std::is_enum_v<T> || std::is_signed_v<T>) {
+            std::int64_t value = (std::int64_t)argument;
+            pack(entry, ARGUMENT_SIGNED, &value, sizeof(value));
+        } else if constexpr (std::is_pointer_v<T>) {
+            std::uint64_t value = (std::uintptr_t)argument;
+            pack(entry, ARGUMENT_UNSIGNED, &value, sizeof(value));
+        } else {
+            std::uint64_t value = argument;
+            pack(entry, ARGUMENT_UNSIGNED, &value, sizeof(value));
+        }
+    }
+
+    /**
+     * Formats an entry the way printf would have, one conversion at a time.
+     * Integer conversions take any integer argument regardless of their
+     * length modifier.
+     *
+     * \param entry
+     *      The entry to format.
+     *
+     * \param text
+     *      The buffer the text is written to, always null terminated.
+     *
+     * \param text_size
+     *      The size of the buffer.
+     */
+    static void format(const Entry* entry, char* text, std::uint32_t text_size);
+
+    /**
+     * Takes the oldest entry from the ring buffer and writes it out as one
+     * tab separated record: the time in milliseconds, the level, the module,
+     * the task and the message, e.g.
+     * "1520\tINFO\trobot\trobot_opcontrol\topcontrol active".
+     *
+     * \param file
+     *      The file to write to, or nullptr for the terminal.
+     *
+     * \return 1 if an entry was written, 0 if the ring buffer was empty.
+     */
+    static std::int32_t drain_one(std::ostream* file);
+
+    /**
+     * Writes the ring buffer out every few milliseconds until stopped, then
+     * writes what is left.
+     *
+     * This function is intended to be used as a task, which is why it is
+     * static.
+     *
+     * \param parameters
+     *      Unused.
+     */
+    static void drain(void* parameters);
+
+    public:
+    /**
+     * Logs a message. Only the format pointer and the arguments are copied,
+     * the message is formatted later by the drain task. The format must
+     * therefore be a string literal, or otherwise outlive the drain. If the
+     * ring buffer is full, the message is dropped and counted.
+     *
+     * This never blocks or allocates, so it is safe on time critical paths.
+     * Use the logging macros instead, which check the level of the module
+     * at compile time.
+     *
+     * \param module
+     *      The module logging.
+     *
+     * \param level
+     *      The level of the message.
+     *
+     * \param format
+     *      The printf style format of the message.
+     *
+     * \param arguments
+     *      The arguments of the format: integers, enums, floating point
+     *      numbers, pointers, C strings or std::strings.
+     */
+    template <typename... Args>
+    static void write(log_module module, log_level level, const char* format, const Args&... arguments) {
+
+        Entry* entry = reserve(module, level, format);
+        if (nullptr == entry) {
+            return;
+        }
+
+        (pack_argument(entry, arguments), ...);
+
+        commit(entry);
+    }
+
+    /**
+     * Starts the drain task, which runs below every other umbc task. Until
+     * it is started, messages are kept in the ring buffer.
+     *
+     * \param file_path
+     *      The file messages are appended to, e.g. "/usd/log.txt", or
+     *      nullptr to write them to the terminal.
+     */
+    static void start(const char* file_path = nullptr);
+
+    /**
+     * Stops the drain task once it has written every message logged so
+     * far, and closes the log file.
+     */
+    static void stop(void);
+
+    /**
+     * Writes every message in the ring buffer to the terminal from the
+     * calling task, e.g. before stopping the program.
+     */
+    static void flush(void);
+
+    /**
+     * Gets the number of messages dropped because the ring buffer was full
+     * since the last call.
+     *
+     * \return The number of dropped messages.
+     */
+    static std::uint32_t get_dropped(void);
+};
+}
+
+#endif // _UMBC_LOG_HPP_
@@ -0,0 +1,195 @@
+/**
+ * \file umbc/looptiming.hpp
+ *
+ * Contains the prototype for the LoopTiming. LoopTiming measures a fixed
+ * period loop: how late each iteration started and how long its body took,
+ * kept in fixed-size histograms so measuring never allocates.
+ */
+
+#ifndef _UMBC_LOOP_TIMING_HPP_
+#define _UMBC_LOOP_TIMING_HPP_
+
+#include "api.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class LoopTiming {
+
+    private:
+    static constexpr std::uint32_t number_of_buckets = 128;
+
+    const char* name;
+    std::uint32_t period_us;
+    std::uint32_t bucket_us;
+    std::uint64_t start_us;
+    std::uint32_t started;
+    std::atomic<std::uint32_t> iterations;
+    std::atomic<std::uint32_t> overruns;
+    std::atomic<std::uint32_t> max_lateness_us;
+    std::atomic<std::uint32_t> max_duration_us;
+    std::atomic<std::uint32_t> lateness[number_of_buckets];
+    std::atomic<std::uint32_t> duration[number_of_buckets];
+
+    /**
+     * Adds a time to a histogram. Times past the last bucket are counted in
+     * the last bucket.
+     *
+     * \param histogram
+     *      The histogram.
+     *
+     * \param time_us
+     *      The time in microseconds.
+     */
+    void add(std::atomic<std::uint32_t>* histogram, std::uint32_t time_us);
+
+    /**
+     * Finds the time that a share of the times in a histogram are at or
+     * below.
+     *
+     * \param histogram
+     *      The histogram.
+     *
+     * \param max_us
+     *      The largest time added to the histogram.
+     *
+     * \param percentile
+     *      The share [0-100].
+     *
+     * \return The upper edge of the bucket the percentile falls in, at most
+     * max_us.
+     */
+    std::uint32_t percentile(std::atomic<std::uint32_t>* histogram, std::uint32_t max_us, float percentile);
+
+    public:
+    /**
+     * Creates the timing of a loop.
+     *
+     * \param name
+     *      The name the statistics are printed under, usually the name of
+     *      the task running the loop. Must outlive the LoopTiming.
+     *
+     * \param period_ms
+     *      The period the loop is meant to run at. The histograms cover up
+     *      to twice the period.
+     */
+    LoopTiming(const char* name, std::uint32_t period_ms);
+
+    /**
+     * Clears the statistics and sets the period of the loop.
+     *
+     * \param period_ms
+     *      The period the loop is meant to run at.
+     */
+    void reset(std::uint32_t period_ms);
+
+    /**
+     * Clears the statistics.
+     */
+    void reset(void);
+
+    /**
+     * Marks the start of an iteration. The lateness of the iteration is how
+     * much longer than the period it has been since the previous iteration
+     * started, so a loop that waits a full period after its body is late by
+     * the length of its body.
+     *
+     * Only the task running the loop should call this function.
+     */
+    void begin(void);
+
+    /**
+     * Marks the end of the body of an iteration, before the loop waits for
+     * the next one. A body that takes longer than the period counts as an
+     * overrun.
+     *
+     * Only the task running the loop should call this function.
+     */
+    void end(void);
+
+    /**
+     * Gets the number of iterations measured.
+     *
+     * \return The number of iterations.
+     */
+    std::uint32_t get_iterations(void);
+
+    /**
+     * Gets the number of iterations whose body took longer than the period.
+     *
+     * \return The number of overruns.
+     */
+    std::uint32_t get_overruns(void);
+
+    /**
+     * Gets the latest an iteration started.
+     *
+     * \return The largest lateness in microseconds.
+     */
+    std::uint32_t get_max_lateness_us(void);
+
+    /**
+     * Gets the longest the body of an iteration took.
+     *
+     * \return The largest body duration in microseconds.
+     */
+    std::uint32_t get_max_duration_us(void);
+
+    /**
+     * Gets the lateness that a share of the iterations started within.
+     *
+     * \param percentile
+     *      The share [0-100], e.g. 99.
+     *
+     * \return The lateness in microseconds, rounded up to the resolution of
+     * the histogram.
+     */
+    std::uint32_t get_lateness_percentile_us(float percentile);
+
+    /**
+     * Gets the body duration that a share of the iterations finished within.
+     *
+     * \param percentile
+     *      The share [0-100], e.g. 99.
+     *
+     * \return The body duration in microseconds, rounded up to the resolution
+     * of the histogram.
+     */
+    std::uint32_t get_duration_percentile_us(float percentile);
+
+    /**
+     * Formats the statistics as a single line.
+     *
+     * \return The iterations, overruns, and the median, 99th percentile and
+     * largest lateness and body duration.
+     */
+    std::string summary(void);
+
+    /**
+     * Prints the statistics to the terminal.
+     */
+    void print(void);
+
+    /**
+     * Saves the statistics and both histograms as a CSV file, one row per
+     * bucket with the upper edge of the bucket in microseconds, and the
+     * number of iterations that started late and took that long. The last
+     * bucket also counts everything longer. The summary is written first,
+     * as a line starting with '#'.
+     *
+     * \param file_path
+     *      The file path that the CSV file will be created and saved at. If a
+     *      file already exists at this location, it will be overwritten.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t save(const char* file_path);
+};
+}
+
+#endif // _UMBC_LOOP_TIMING_HPP_
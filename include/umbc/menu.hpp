@@ -0,0 +1,149 @@
+/**
+ * \file umbc/menu.hpp
+ *
+ * Contains the prototype for the Menu. The Menu is a table of screens shown
+ * on the LLEMU, each a title and a list of items. Selecting an item runs its
+ * action and moves to another screen, back to the previous one, or ends the
+ * menu, so screens can be nested as deep as needed.
+ */
+
+#ifndef _UMBC_MENU_HPP_
+#define _UMBC_MENU_HPP_
+
+#include "api.h"
+#include "pros/apix.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+typedef enum {
+    MENU_BACK = -1,
+    MENU_DONE = -2
+} menu_target;
+
+/**
+ * An item of a menu screen.
+ */
+struct MenuItem {
+    std::string label;
+    std::int32_t next;
+    std::function<void(void)> select;
+};
+
+class Menu {
+
+    private:
+    static constexpr std::int16_t title_line = 1;
+    static constexpr std::int16_t first_item_line = 3;
+    static constexpr std::int16_t number_of_lines = 8;
+    static constexpr std::uint32_t number_of_visible_items = number_of_lines - first_item_line;
+
+    // owned by the menu rather than the task running it, competition
+    // initialize is deleted by PROS while it waits in run
+    static std::atomic<pros::c::sem_t> button_semaphore;
+    static std::atomic<std::uint32_t> pressed_buttons;
+
+    struct Screen {
+        std::string title;
+        std::vector<MenuItem> items;
+    };
+
+    std::map<std::int32_t, Screen> screens;
+
+    /**
+     * Records that an LLEMU button was pressed and wakes the task running
+     * the menu. Presses while no menu is running are dropped by the next
+     * run.
+     *
+     * \param button
+     *      The button, LCD_BTN_LEFT, LCD_BTN_CENTER or LCD_BTN_RIGHT.
+     */
+    static void press(std::uint32_t button);
+
+    /**
+     * LLEMU callbacks of the left, center and right button.
+     */
+    static void press_left(void);
+    static void press_center(void);
+    static void press_right(void);
+
+    /**
+     * Draws a screen, scrolled so the item under the cursor is visible.
+     *
+     * \param screen
+     *      The screen.
+     *
+     * \param cursor
+     *      The index of the item under the cursor.
+     */
+    void draw(const Screen& screen, std::uint32_t cursor);
+
+    public:
+    /**
+     * Creates a menu without screens.
+     */
+    Menu();
+
+    /**
+     * Adds a screen, or renames it if it exists.
+     *
+     * \param screen
+     *      The id of the screen, 0 or greater.
+     *
+     * \param title
+     *      The text shown above the items.
+     */
+    void set_screen(std::int32_t screen, const std::string& title);
+
+    /**
+     * Adds an item to the end of a screen, adding the screen if needed.
+     *
+     * \param screen
+     *      The id of the screen.
+     *
+     * \param label
+     *      The text of the item.
+     *
+     * \param next
+     *      The screen shown after the item is selected, MENU_BACK for the
+     *      screen shown before this one, or MENU_DONE to end the menu.
+     *
+     * \param select
+     *      The action run when the item is selected, or nullptr.
+     */
+    void add_item(std::int32_t screen, const std::string& label, std::int32_t next,
+        std::function<void(void)> select = nullptr);
+
+    /**
+     * Removes every item of a screen, e.g. to refill a list that changed.
+     *
+     * \param screen
+     *      The id of the screen.
+     */
+    void clear_items(std::int32_t screen);
+
+    /**
+     * Shows the menu on the LLEMU until an item leading to MENU_DONE is
+     * selected. The left and right buttons move the cursor, the center
+     * button selects. The calling task sleeps on a semaphore between button
+     * presses, which the LLEMU callbacks post to.
+     *
+     * \param screen
+     *      The id of the first screen.
+     *
+     * \return 1 on success, 0 if the LLEMU is not initialized or a screen
+     * to show has no items.
+     */
+    std::int32_t run(std::int32_t screen);
+};
+}
+
+#endif // _UMBC_MENU_HPP_
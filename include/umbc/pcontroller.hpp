@@ -19,6 +19,7 @@ namespace umbc {
 class PController : public umbc::Controller {
 
     private:
+    controller_id_e_t id;
     pros::Controller controller;
 
     public:
@@ -128,6 +129,22 @@ class PController : public umbc::Controller {
 	 */
 	std::int32_t get_digital_new_press(controller_digital_e_t button);
 
+	/**
+	 * Gets the state of every analog and digital channel in one call.
+	 *
+	 * The channels are read straight from the PROS C API, and none are read
+	 * if the controller is not connected.
+	 *
+	 * This function uses the following values of errno when an error state is
+	 * reached:
+	 * EACCES - Another resource is currently trying to access the controller
+	 * port.
+	 *
+	 * \return The current controller input. If the controller was not
+	 * connected, then every channel is 0
+	 */
+	ControllerInput snapshot(void);
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
 	template <typename T>
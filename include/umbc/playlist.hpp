@@ -0,0 +1,142 @@
+/**
+ * \file umbc/playlist.hpp
+ *
+ * Contains the prototype for the Playlist. A Playlist lists recorded
+ * controller input files (clips) to be played back one after another, with
+ * an optional gap of neutral controller input before each clip.
+ *
+ * A playlist is saved as a binary manifest. Like a versioned controller
+ * input file it starts with a zero poll rate, so Recording::load can tell
+ * them apart. All multi-byte values are little-endian:
+ *
+ *   0  uint16_t  0
+ *   2  char[4]   "UMBP"
+ *   6  uint8_t   version, 1
+ *   7  uint8_t   number of clips
+ *   8            clips
+ *
+ * Each clip is:
+ *
+ *   0  uint16_t  gap before the clip in milliseconds
+ *   2  uint8_t   length of the file path
+ *   3  char[]    file path, not null terminated
+ */
+
+#ifndef _UMBC_PLAYLIST_HPP_
+#define _UMBC_PLAYLIST_HPP_
+
+#include "api.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class Playlist {
+
+    public:
+    static constexpr std::uint32_t max_clips = UINT8_MAX;
+    static constexpr std::uint32_t max_path_length = UINT8_MAX;
+
+    private:
+    std::vector<std::string> clips;
+    std::vector<std::uint16_t> gaps;
+
+    public:
+    /**
+     * Creates an empty playlist.
+     */
+    Playlist();
+
+    /**
+     * Checks if a buffer holds a playlist manifest rather than controller
+     * input.
+     *
+     * \param data
+     *      The contents of the file.
+     *
+     * \param size
+     *      The size of the buffer in bytes.
+     *
+     * \return 1 if the buffer starts with a playlist header, otherwise 0
+     */
+    static std::int32_t is_playlist(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Adds a clip to the end of the playlist.
+     *
+     * \param clip_path
+     *      The path of the controller input file to play.
+     *
+     * \param gap_ms
+     *      How long to play neutral controller input before the clip.
+     *
+     * \return 1 on success, 0 if the playlist is full or the path is too
+     * long.
+     */
+    std::int32_t add(const char* clip_path, std::uint16_t gap_ms = 0);
+
+    /**
+     * Removes all clips from the playlist.
+     */
+    void clear();
+
+    /**
+     * Reads a playlist from a manifest held in memory, replacing any clips
+     * in the playlist.
+     *
+     * \param data
+     *      The contents of the manifest.
+     *
+     * \param size
+     *      The size of the buffer in bytes.
+     *
+     * \return 1 on success, 0 if the manifest is invalid or truncated.
+     */
+    std::int32_t parse(const std::uint8_t* data, std::size_t size);
+
+    /**
+     * Saves the playlist as a manifest.
+     *
+     * \param file_path
+     *      The file path that the manifest will be created and saved at. If
+     *      a file already exists at this location, it will be overwritten.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t save(const char* file_path);
+
+    /**
+     * Gets the number of clips in the playlist.
+     *
+     * \return The number of clips.
+     */
+    std::uint32_t size();
+
+    /**
+     * Gets the path of a clip.
+     *
+     * \param clip
+     *      The clip, must be less than size.
+     *
+     * \return The path of the controller input file.
+     */
+    const std::string& get_clip(std::uint32_t clip);
+
+    /**
+     * Gets the gap before a clip.
+     *
+     * \param clip
+     *      The clip, must be less than size.
+     *
+     * \return The gap in milliseconds.
+     */
+    std::uint16_t get_gap(std::uint32_t clip);
+};
+}
+
+#endif // _UMBC_PLAYLIST_HPP_
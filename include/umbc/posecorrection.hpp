@@ -0,0 +1,109 @@
+/**
+ * \file umbc/posecorrection.hpp
+ *
+ * Contains the prototype for the PoseCorrection. PoseCorrection closes the
+ * loop around playback: it compares the pose recorded with each frame
+ * against the current odometry pose, and adds a proportional correction to
+ * the drive sticks of the replayed controller input, so battery voltage and
+ * field friction do not make the robot drift off the recorded path.
+ */
+
+#ifndef _UMBC_POSE_CORRECTION_HPP_
+#define _UMBC_POSE_CORRECTION_HPP_
+
+#include "controllerinput.hpp"
+#include "posetrack.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "api.h"
+
+#include <cstdint>
+#include <memory>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+typedef enum {
+    CORRECTION_ARCADE = 0,
+    CORRECTION_SINGLE_ARCADE = 1,
+    CORRECTION_TANK = 2
+} correction_drive;
+
+class PoseCorrection {
+
+    private:
+    okapi::Odometry* odometry;
+    std::shared_ptr<PoseTrack> pose_track;
+    correction_drive drive;
+    float kp_forward;
+    float kp_lateral;
+    float kp_turn;
+    std::int32_t max_correction;
+
+    public:
+    /**
+     * Creates a pose correction.
+     *
+     * \param odometry
+     *      The odometry of the robot. It must be stepped by its own task, as
+     *      okapi's odometry chassis controller does. The playback task only
+     *      reads it, it is set once by start.
+     *
+     * \param pose_track
+     *      The poses recorded with the controller input being played back.
+     *
+     * \param drive
+     *      Which sticks drive the robot. CORRECTION_ARCADE is left y forward
+     *      and right x turn, CORRECTION_SINGLE_ARCADE is left y forward and
+     *      left x turn, CORRECTION_TANK is left y and right y.
+     *
+     * \param kp_forward
+     *      Stick units added per millimeter the robot is behind the recorded
+     *      pose.
+     *
+     * \param kp_lateral
+     *      Stick units of turn added per millimeter the robot is to the side
+     *      of the recorded pose.
+     *
+     * \param kp_turn
+     *      Stick units of turn added per degree the robot is facing away
+     *      from the recorded heading.
+     *
+     * \param max_correction
+     *      The most a correction may move a stick, so a bad odometry reading
+     *      cannot take over from the recorded controller input.
+     */
+    PoseCorrection(okapi::Odometry* odometry, std::shared_ptr<PoseTrack> pose_track,
+        correction_drive drive = CORRECTION_ARCADE, float kp_forward = 0.5, float kp_lateral = 0.25,
+        float kp_turn = 1.5, std::uint8_t max_correction = 32);
+
+    /**
+     * Sets the odometry to the recorded pose of the frame playback starts
+     * from. Playback already assumes the robot starts where it was at that
+     * frame while recording, so this lines the odometry up with the pose
+     * track.
+     *
+     * Call this from the task that starts playback, before it is started,
+     * the same way a chassis controller's state is set from autonomous. It
+     * is never called from the playback task.
+     *
+     * \param frame
+     *      The frame of the recording playback starts from.
+     */
+    void start(std::uint32_t frame);
+
+    /**
+     * Adds the correction towards the recorded pose of a frame to the drive
+     * sticks. Nothing is changed past the end of the pose track.
+     *
+     * \param frame
+     *      The frame of the recording being played back.
+     *
+     * \param controller_input
+     *      The recorded controller input of the frame, updated in place.
+     */
+    void correct(std::uint32_t frame, ControllerInput& controller_input);
+};
+}
+
+#endif // _UMBC_POSE_CORRECTION_HPP_
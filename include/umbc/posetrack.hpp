@@ -0,0 +1,139 @@
+/**
+ * \file umbc/posetrack.hpp
+ *
+ * Contains the prototype for the PoseTrack. A PoseTrack holds the odometry
+ * pose of the robot for every frame of a recording, so playback can steer
+ * back onto the path that was driven while recording.
+ *
+ * A pose track is saved next to its controller input file, see path_for.
+ * Like a versioned controller input file it starts with a zero poll rate.
+ * All multi-byte values are little-endian:
+ *
+ *   0  uint16_t  0
+ *   2  char[4]   "UMBO"
+ *   6  uint8_t   version, 1
+ *   7  uint8_t   reserved, 0
+ *   8  uint16_t  poll rate in milliseconds
+ *  10  uint32_t  number of poses
+ *  14            poses
+ *
+ * Each pose is 6 bytes: the int16_t x and y in millimeters followed by the
+ * int16_t heading in hundredths of a degree, wrapped to [-180, 180). The
+ * pose at index i was sampled with frame i of the controller input file.
+ */
+
+#ifndef _UMBC_POSE_TRACK_HPP_
+#define _UMBC_POSE_TRACK_HPP_
+
+#include "okapi/api/odometry/odomState.hpp"
+#include "api.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class PoseTrack {
+
+    public:
+    static constexpr std::uint32_t header_size = 14;
+    static constexpr std::uint32_t pose_size = 6;
+
+    private:
+    std::uint16_t poll_rate_ms;
+    std::vector<std::int16_t> poses;
+
+    public:
+    /**
+     * Creates an empty pose track.
+     *
+     * \param poll_rate_ms
+     *      The rate in milliseconds poses are sampled at.
+     */
+    PoseTrack(std::uint16_t poll_rate_ms = 0);
+
+    /**
+     * Gets the path a pose track is saved at for a controller input file,
+     * which is the file path with its extension replaced by ".pose".
+     *
+     * \param file_path
+     *      The path of the controller input file.
+     *
+     * \return The path of the pose track.
+     */
+    static std::string path_for(const std::string& file_path);
+
+    /**
+     * Adds a pose to the end of the track.
+     *
+     * \param state
+     *      The pose, e.g. from okapi::Odometry::getState.
+     */
+    void push(const okapi::OdomState& state);
+
+    /**
+     * Makes room for a number of poses, so pushing that many never
+     * allocates.
+     *
+     * \param number_of_poses
+     *      The number of poses the track should hold without growing.
+     */
+    void reserve(std::uint32_t number_of_poses);
+
+    /**
+     * Saves the pose track into a binary file.
+     *
+     * \param file_path
+     *      The file path that the binary file will be created and saved at. If
+     *      a file already exists at this location, it will be overwritten.
+     *
+     * \return Number of poses written to the file, otherwise -1 on failure.
+     */
+    std::int32_t save(const char* file_path);
+
+    /**
+     * Reads a pose track file, replacing any poses already in the track.
+     *
+     * \param file_path
+     *      The path of the pose track file.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t load(const char* file_path);
+
+    /**
+     * Removes every pose.
+     */
+    void clear(void);
+
+    /**
+     * Gets the number of poses.
+     *
+     * \return The number of poses in the track.
+     */
+    std::uint32_t size(void);
+
+    /**
+     * Gets the rate poses were sampled at.
+     *
+     * \return The poll rate in milliseconds.
+     */
+    std::uint16_t get_poll_rate(void);
+
+    /**
+     * Gets a pose.
+     *
+     * \param frame
+     *      The frame of the recording the pose was sampled with, must be
+     *      less than size.
+     *
+     * \return The pose.
+     */
+    okapi::OdomState get_pose(std::uint32_t frame);
+};
+}
+
+#endif // _UMBC_POSE_TRACK_HPP_
@@ -0,0 +1,232 @@
+/**
+ * \file umbc/recording.hpp
+ *
+ * Contains the prototype for the Recording. A Recording holds the decoded
+ * contents of a controller input file so it can be loaded ahead of time and
+ * handed to a VController for playback.
+ *
+ * Controller input is held as events rather than one entry per poll. An
+ * event is a controller input and the frame and time it started, and it
+ * lasts, one frame per poll rate, until the next event starts. A new event
+ * starts when the controller input changes or a frame was sampled off the
+ * poll rate, so held inputs take no memory.
+ */
+
+#ifndef _UMBC_RECORDING_HPP_
+#define _UMBC_RECORDING_HPP_
+
+#include "controllerinput.hpp"
+#include "api.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class Recording {
+
+    private:
+    std::uint16_t poll_rate_ms;
+    controller_id_e_t controller_id;
+    std::vector<ControllerInput> events;
+    std::vector<std::uint32_t> event_frames;
+    std::vector<std::uint32_t> event_times;
+    std::uint32_t number_of_frames;
+
+    static constexpr std::uint32_t max_playlist_depth = 4;
+
+    /**
+     * Reads a controller input file or playlist manifest into the
+     * recording, see load.
+     *
+     * \param file_path
+     *      The path of the file to load.
+     *
+     * \param depth
+     *      How many playlists deep this file is, so a playlist that lists
+     *      itself cannot recurse forever.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t load(const char* file_path, std::uint32_t depth);
+
+    /**
+     * Loads every clip in a playlist manifest and appends them to the
+     * recording.
+     *
+     * \param data
+     *      The contents of the manifest.
+     *
+     * \param size
+     *      The size of the buffer in bytes.
+     *
+     * \param file_path
+     *      The path of the manifest, used for logging.
+     *
+     * \param depth
+     *      How many playlists deep this manifest is.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t load_playlist(const std::uint8_t* data, std::size_t size, const char* file_path, std::uint32_t depth);
+
+    public:
+    /**
+     * Creates an empty recording.
+     */
+    Recording();
+
+    /**
+     * Reads a controller input file, saves the poll rate, and decodes the
+     * controller inputs from the file into the recording.
+     *
+     * The file is read with a single read into memory and decoded into
+     * events, so playback only advances an index and never allocates.
+     *
+     * All file format versions, including legacy files which start with a
+     * bare poll rate, are accepted. Files whose CRC does not match are
+     * rejected. If the poll rate in the file is zero, this function will
+     * fail since zero is an illegal poll rate value.
+     *
+     * The file may also be a playlist manifest, see Playlist, in which case
+     * every clip is loaded and concatenated into this recording up front,
+     * so playback never goes back to the SD card between clips.
+     *
+     * \param file_path
+     *      The path for the file to retrieve the poll rate and load the
+     *      controller input from.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    std::int32_t load(const char* file_path);
+
+    /**
+     * Appends a clip to the end of the recording, optionally after a gap of
+     * neutral controller input. The clip is copied.
+     *
+     * \param clip
+     *      The recording to append. It must have the same poll rate as this
+     *      recording, unless this recording is empty.
+     *
+     * \param gap_ms
+     *      How long to play neutral controller input before the clip,
+     *      rounded up to whole polls.
+     *
+     * \return 1 on success, 0 if the poll rates do not match.
+     */
+    std::int32_t append(const Recording& clip, std::uint32_t gap_ms = 0);
+
+    /**
+     * Removes all controller input from the recording.
+     */
+    void clear();
+
+    /**
+     * Gets the rate the controller input was recorded at.
+     *
+     * \return The poll rate in milliseconds, or 0 if nothing is loaded.
+     */
+    std::uint16_t get_poll_rate();
+
+    /**
+     * Gets the controller the input was recorded from.
+     *
+     * \return The controller id stored in the file header.
+     */
+    controller_id_e_t get_controller_id();
+
+    /**
+     * Gets the number of frames, one per poll, in the recording.
+     *
+     * \return The number of frames, or 0 if nothing is loaded.
+     */
+    std::uint32_t size();
+
+    /**
+     * Gets the number of events in the recording.
+     *
+     * \return The number of events, or 0 if nothing is loaded.
+     */
+    std::uint32_t get_number_of_events();
+
+    /**
+     * Finds the event a frame belongs to with a binary search. Sequential
+     * playback should instead advance to the next event once its first frame
+     * is reached.
+     *
+     * \param frame
+     *      The frame to find, must be less than size.
+     *
+     * \return The index of the event the frame belongs to.
+     */
+    std::uint32_t find_event(std::uint32_t frame);
+
+    /**
+     * Finds the event playing at a time with a binary search.
+     *
+     * \param time_ms
+     *      The time in milliseconds since the first frame.
+     *
+     * \return The index of the last event that starts at or before the time.
+     */
+    std::uint32_t find_event_at(std::uint32_t time_ms);
+
+    /**
+     * Gets the length of the recording. The last frame is held for one poll.
+     *
+     * \return The length of the recording in milliseconds, or 0 if nothing
+     * is loaded.
+     */
+    std::uint32_t get_duration();
+
+    /**
+     * Gets the controller input of an event.
+     *
+     * \param event
+     *      The event, must be less than get_number_of_events.
+     *
+     * \return The controller input held for the whole event.
+     */
+    const ControllerInput& get_event(std::uint32_t event);
+
+    /**
+     * Gets the first frame of an event.
+     *
+     * \param event
+     *      The event, must be less than get_number_of_events.
+     *
+     * \return The frame the event starts at.
+     */
+    std::uint32_t get_event_frame(std::uint32_t event);
+
+    /**
+     * Gets when a frame was recorded, in milliseconds since the first frame.
+     * Playback should follow this timeline rather than the poll rate so it
+     * stays in sync when the recorder ran late.
+     *
+     * \param frame
+     *      The frame, must be less than size.
+     *
+     * \param event
+     *      The event the frame belongs to.
+     *
+     * \return The time of the frame in milliseconds.
+     */
+    std::uint32_t get_time(std::uint32_t frame, std::uint32_t event);
+
+    /**
+     * Gets the controller input of a frame. See find_event.
+     *
+     * \param frame
+     *      The frame, must be less than size.
+     *
+     * \return The controller input at the frame.
+     */
+    const ControllerInput& get_frame(std::uint32_t frame);
+};
+}
+
+#endif // _UMBC_RECORDING_HPP_
@@ -0,0 +1,145 @@
+/**
+ * \file umbc/recordingcache.hpp
+ *
+ * Contains the prototype for the RecordingCache. The RecordingCache loads
+ * and decodes controller input files in a background task and keeps the
+ * resulting recordings keyed by file path, so playback can start without
+ * waiting on the SD card. The pose track saved next to a file, if there is
+ * one, is loaded and kept with it.
+ */
+
+#ifndef _UMBC_RECORDING_CACHE_HPP_
+#define _UMBC_RECORDING_CACHE_HPP_
+
+#include "posetrack.hpp"
+#include "recording.hpp"
+#include "api.h"
+#include "pros/apix.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class RecordingCache {
+
+    private:
+    static constexpr char* t_preload_name = (char*)"recordingcache";
+    static constexpr std::uint32_t wait_timeout_ms = 2000;
+
+    pros::Mutex mutex;
+    std::map<std::string, std::shared_ptr<Recording>> recordings;
+    std::map<std::string, std::shared_ptr<PoseTrack>> pose_tracks;
+    std::vector<std::string> pending;
+    std::unique_ptr<Task> t_preload;
+
+    // posted by the preload task each time it finishes a file, every task
+    // woken passes it on while others are still waiting
+    pros::c::sem_t preloaded;
+    std::uint32_t waiters;
+
+    /**
+     * Loads the pending file paths into the cache whenever it is notified
+     * by preload.
+     *
+     * This function is intended to be used as a task, which is why it is
+     * static.
+     *
+     * \param RecordingCache
+     *          The recording cache whose pending file paths will be loaded.
+     *          The type for this parameter must be RecordingCache.
+     *          Intended to be 'this' pointer.
+     */
+    static void preload_pending(void* RecordingCache);
+
+    /**
+     * Waits for a controller input file that is being preloaded. The
+     * calling task is blocked until the preload task finishes a file, for
+     * at most wait_timeout_ms in total.
+     *
+     * \param file_path
+     *      The path of the controller input file.
+     *
+     * \return 1 if the file is in the cache, 0 if it was never preloaded,
+     * otherwise -1 if it was not preloaded in time.
+     */
+    std::int32_t wait_for(const std::string& file_path);
+
+    /**
+     * Loads a controller input file and the pose track saved next to it on
+     * the calling task, and adds them to the cache.
+     *
+     * \param file_path
+     *      The path of the controller input file.
+     */
+    void load(const std::string& file_path);
+
+    public:
+    /**
+     * Creates an empty recording cache.
+     */
+    RecordingCache();
+
+    /**
+     * Stops the preload task.
+     */
+    ~RecordingCache();
+
+    /**
+     * Queues a controller input file to be loaded in the background. The
+     * preload task is created on first use and runs below the default
+     * priority.
+     *
+     * \param file_path
+     *      The path of the controller input file to load.
+     */
+    void preload(const char* file_path);
+
+    /**
+     * Gets the recording for a controller input file.
+     *
+     * If the file is still being preloaded this waits for it to finish. If
+     * the file was never preloaded, or is not preloaded within
+     * wait_timeout_ms, it is loaded on the calling task.
+     *
+     * \param file_path
+     *      The path of the controller input file.
+     *
+     * \return The recording, or nullptr if the file could not be loaded.
+     */
+    std::shared_ptr<Recording> get(const char* file_path);
+
+    /**
+     * Gets the pose track saved next to a controller input file, see
+     * PoseTrack::path_for. Waits for or loads the file the same as get.
+     *
+     * \param file_path
+     *      The path of the controller input file.
+     *
+     * \return The pose track, or nullptr if the file has none.
+     */
+    std::shared_ptr<PoseTrack> get_pose_track(const char* file_path);
+
+    /**
+     * Removes a controller input file and its pose track from the cache,
+     * e.g. after it has been overwritten. The next get or preload will read
+     * it again.
+     *
+     * \param file_path
+     *      The path of the controller input file.
+     */
+    void remove(const char* file_path);
+
+    /**
+     * Removes all recordings and pose tracks from the cache.
+     */
+    void clear();
+};
+}
+
+#endif // _UMBC_RECORDING_CACHE_HPP_
@@ -0,0 +1,220 @@
+/**
+ * \file umbc/recordingpath.hpp
+ *
+ * Contains the prototype for the RecordingPath. A RecordingPath turns a
+ * recorded run into squiggles motion profiles. The path the robot drove is
+ * taken from the pose track recorded with the run, or dead reckoned from
+ * the drive sticks if there is none, split wherever the robot stops to turn
+ * or changes direction, and thinned to a few waypoints. Each part is then
+ * generated as a time optimal profile within the drive constraints.
+ *
+ * Profiles are saved as squiggles CSV files, which can be loaded with
+ * okapi's AsyncMotionProfileController::loadPath.
+ */
+
+#ifndef _UMBC_RECORDING_PATH_HPP_
+#define _UMBC_RECORDING_PATH_HPP_
+
+#include "posecorrection.hpp"
+#include "posetrack.hpp"
+#include "recording.hpp"
+#include "okapi/squiggles/squiggles.hpp"
+#include "api.h"
+
+#include <cstdint>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+class RecordingPath {
+
+    private:
+    static constexpr double waypoint_spacing_m = 0.01;
+    static constexpr double max_bend_rad = 1.0;
+    static constexpr double profile_dt_s = 0.01;
+
+    double track_width_m;
+    double max_velocity;
+    double max_acceleration;
+    double max_jerk;
+    correction_drive drive;
+    double max_speed_mps;
+    double max_turn_rate_rps;
+    std::vector<std::vector<squiggles::Pose>> segments;
+    std::vector<std::uint8_t> backwards;
+
+    /**
+     * Dead reckons the pose of the robot at every frame of a recording from
+     * its drive sticks, see set_drive_model.
+     *
+     * \param recording
+     *      The recorded controller input.
+     *
+     * \param poses
+     *      Set to the pose at every frame, in meters and radians.
+     */
+    void reckon(Recording& recording, std::vector<squiggles::Pose>& poses);
+
+    /**
+     * Splits the driven path into segments wherever the robot turns in
+     * place or changes between driving forwards and backwards, then thins
+     * each segment to waypoints.
+     *
+     * \param poses
+     *      The pose at every frame, in meters and radians.
+     *
+     * \param tolerance_m
+     *      How far the waypoints may cut corners of the driven path.
+     */
+    void split(const std::vector<squiggles::Pose>& poses, double tolerance_m);
+
+    /**
+     * Thins points to the fewest that stay within a tolerance of them, by
+     * repeatedly keeping the point furthest from the line between two kept
+     * points. The first and last points are always kept.
+     *
+     * \param points
+     *      The points to thin.
+     *
+     * \param tolerance_m
+     *      The largest distance a dropped point may be from the line.
+     *
+     * \return The kept points.
+     */
+    static std::vector<squiggles::Pose> thin(const std::vector<squiggles::Pose>& points, double tolerance_m);
+
+    public:
+    /**
+     * Creates a converter for a tank drive.
+     *
+     * \param track_width_m
+     *      The distance between the left and right wheels in meters.
+     *
+     * \param max_velocity
+     *      The fastest the profile may drive in meters per second.
+     *
+     * \param max_acceleration
+     *      The fastest the profile may accelerate in meters per second per
+     *      second.
+     *
+     * \param max_jerk
+     *      The largest jerk of the profile in meters per second cubed.
+     */
+    RecordingPath(double track_width_m, double max_velocity, double max_acceleration, double max_jerk);
+
+    /**
+     * Sets how the drive sticks move the robot, used to dead reckon runs
+     * recorded without a pose track.
+     *
+     * \param drive
+     *      Which sticks drive the robot, see PoseCorrection.
+     *
+     * \param max_speed_mps
+     *      How fast the robot drives with the forward stick at 127 in
+     *      meters per second.
+     *
+     * \param max_turn_rate_rps
+     *      How fast the robot turns with the turn stick at 127 in radians per
+     *      second.
+     */
+    void set_drive_model(correction_drive drive, double max_speed_mps, double max_turn_rate_rps);
+
+    /**
+     * Fits waypoints to a recorded run.
+     *
+     * \param recording
+     *      The recorded controller input.
+     *
+     * \param pose_track
+     *      The poses recorded with the run, or nullptr to dead reckon the
+     *      path from the drive sticks.
+     *
+     * \param tolerance_m
+     *      How far the waypoints may cut corners of the driven path. Larger
+     *      values give fewer waypoints and a smoother profile.
+     *
+     * \return The number of segments fitted.
+     */
+    std::uint32_t fit(Recording& recording, PoseTrack* pose_track = nullptr, double tolerance_m = 0.05);
+
+    /**
+     * Gets the number of segments fitted.
+     *
+     * \return The number of segments.
+     */
+    std::uint32_t size(void);
+
+    /**
+     * Gets the waypoints of a segment, in the okapi frame transformation
+     * convention: +x is forward, +y is right and the yaw is the direction of
+     * travel measured from +x to +y.
+     *
+     * \param segment
+     *      The segment, must be less than size.
+     *
+     * \return The waypoints of the segment.
+     */
+    const std::vector<squiggles::Pose>& get_waypoints(std::uint32_t segment);
+
+    /**
+     * Checks if a segment was driven backwards, in which case its profile
+     * must be followed backwards, e.g. with
+     * AsyncMotionProfileController::setTarget(path_id, true).
+     *
+     * \param segment
+     *      The segment, must be less than size.
+     *
+     * \return 1 if the segment was driven backwards, otherwise 0
+     */
+    std::int32_t is_backwards(std::uint32_t segment);
+
+    /**
+     * Generates the motion profile of a segment.
+     *
+     * \param segment
+     *      The segment, must be less than size.
+     *
+     * \return The motion profile, empty if the waypoints could not be
+     * joined within the constraints.
+     */
+    std::vector<squiggles::ProfilePoint> generate(std::uint32_t segment);
+
+    /**
+     * Saves a motion profile as a squiggles CSV file.
+     *
+     * \param file_path
+     *      The file path that the CSV file will be created and saved at. If a
+     *      file already exists at this location, it will be overwritten.
+     *
+     * \param profile
+     *      The motion profile to save.
+     *
+     * \return 1 on success, 0 otherwise.
+     */
+    static std::int32_t save(const char* file_path, const std::vector<squiggles::ProfilePoint>& profile);
+
+    /**
+     * Converts a controller input file into motion profiles. The pose track
+     * saved next to the file is used if there is one. Segment n is saved as
+     * "<path_id>-<n>.csv" in the directory, so it can be loaded with
+     * AsyncMotionProfileController::loadPath(directory, "<path_id>-<n>").
+     *
+     * \param file_path
+     *      The controller input file to convert.
+     *
+     * \param directory
+     *      The directory the profiles are saved in, e.g. "/usd/paths". It
+     *      must already exist.
+     *
+     * \param path_id
+     *      The name the profiles are saved under.
+     *
+     * \return The number of profiles saved, otherwise -1 on failure.
+     */
+    std::int32_t convert(const char* file_path, const char* directory, const char* path_id);
+};
+}
+
+#endif // _UMBC_RECORDING_PATH_HPP_
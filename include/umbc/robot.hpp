@@ -10,8 +10,13 @@
 #define _UMBC_ROBOT_HPP_
 
 #include "controller.hpp"
+#include "looptiming.hpp"
+#include "menu.hpp"
 #include "pcontroller.hpp"
 #include "vcontroller.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "recordingcache.hpp"
+#include "routinecatalog.hpp"
 #include "api.h"
 
 #include <cstdint>
@@ -34,6 +39,7 @@ typedef enum {
 typedef enum {
     MENU_COMPETITION = 0,
     MENU_MODE = 1,
+    MENU_ROUTINE = 2,
     MENU_MAX
 } sub_menu;
 
@@ -42,14 +48,14 @@ class Robot {
     private:
     static constexpr char* t_opcontrol_name =  (char*)"robot_opcontrol";
 
-    static constexpr char* match_autonomous_file_master = (char*)"/usd/autonomous_match.bin";
-    static constexpr char* match_autonomous_file_partner = (char*)"/usd/autonomous_match-partner.bin";
-    static constexpr char* skills_autonomous_file_master = (char*)"/usd/autonomous_skills.bin";
-    static constexpr char* skills_autonomous_file_partner = (char*)"/usd/autonomous_skills-partner.bin";
+    static constexpr char* match_routine_tag = (char*)"match";
+    static constexpr char* skills_routine_tag = (char*)"skills";
 
     static constexpr uint32_t match_autonomous_time_ms = 45000;
     static constexpr uint32_t skills_autonomous_time_ms = 60000;
     static constexpr uint32_t opcontrol_delay_ms = 10;
+    static constexpr uint16_t record_poll_rate_ms = 5;
+    static constexpr uint8_t analog_deadband = 2;
 
     umbc::competition competition;
     umbc::mode mode;
@@ -57,27 +63,24 @@ class Robot {
     umbc::PController pcontroller_master = umbc::PController(E_CONTROLLER_MASTER);
     umbc::PController pcontroller_partner = umbc::PController(E_CONTROLLER_PARTNER);
 
-    umbc::VController vcontroller_master = umbc::VController();
-    umbc::VController vcontroller_partner = umbc::VController();
+    // played back at the opcontrol rate, so each opcontrol tick moves
+    // playback forward by one loop under every playback policy
+    umbc::VController vcontroller_master = umbc::VController(opcontrol_delay_ms);
+    umbc::VController vcontroller_partner = umbc::VController(opcontrol_delay_ms);
 
     umbc::Controller* controller_master = &vcontroller_master;
     umbc::Controller* controller_partner = &pcontroller_partner;
 
-    std::unique_ptr<Task> t_opcontrol;
+    umbc::RecordingCache autonomous_cache;
 
-    /**
-     * Menu to select the competition type using the LLEMU.
-     * 
-     * \returns always 1
-     */
-    std::int32_t menu_competition();
+    umbc::RoutineCatalog routine_catalog;
+    std::uint32_t routine_slot;
 
-    /**
-     * Menu to select the mode using the LLEMU.
-     * 
-     * \returns 1 if a selection was made, otherwise -1.
-     */
-    std::int32_t menu_mode();
+    okapi::Odometry* odometry = nullptr;
+
+    umbc::LoopTiming opcontrol_timing = umbc::LoopTiming(t_opcontrol_name, opcontrol_delay_ms);
+
+    std::unique_ptr<Task> t_opcontrol;
 
     /**
      * Allows operator to manually control the robot via a controller. Used
@@ -89,6 +92,34 @@ class Robot {
      */
     static void robot_opcontrol(Robot* robot);
 
+    /**
+     * Marks the start of an opcontrol loop, see get_opcontrol_timing.
+     */
+    void opcontrol_begin();
+
+    /**
+     * Marks the end of an opcontrol loop for the virtual controllers, so
+     * their playback can keep step with opcontrol, see
+     * VController::set_policy.
+     */
+    void opcontrol_tick();
+
+    /**
+     * Gets the tag of the routines for the competition setting.
+     *
+     * \return "skills" for skills, otherwise "match"
+     */
+    const char* get_routine_tag();
+
+    /**
+     * Lists the routines for the competition setting on the routine screen
+     * of the menu.
+     *
+     * \param menu
+     *          The menu to fill.
+     */
+    void fill_routine_menu(umbc::Menu& menu);
+
     public:
     
     /**
@@ -96,6 +127,16 @@ class Robot {
 	 */
     Robot();
 
+    /**
+     * Sets the odometry used to record the pose of the robot while training
+     * autonomous, and to correct drift from the recorded poses during
+     * autonomous. Only the master controller is played back closed loop.
+     * 
+     * \param odometry
+     *          The odometry of the robot, or nullptr to play back open loop.
+     */
+    void set_odometry(okapi::Odometry* odometry);
+
     /**
      * Sets the controllers to use physical controllers.
      */
@@ -120,12 +161,54 @@ class Robot {
     */
     umbc::mode get_mode();
 
+    /**
+     * Indexes the autonomous routines on the SD card. Only the header of
+     * each file is read. Called once at startup, menu and train_autonomous
+     * scan on first use if it was not.
+     */
+    void scan_routines();
+
+    /**
+     * Gets the index of the autonomous routines on the SD card.
+     *
+     * \return the routine catalog
+     */
+    umbc::RoutineCatalog& get_routine_catalog();
+
+    /**
+     * Selects the routine played by autonomous for the competition setting.
+     *
+     * \param slot
+     *          The slot of the routine, see RoutineCatalog.
+     */
+    void set_routine_slot(std::uint32_t slot);
+
+    /**
+     * Retrieve the selected routine.
+     *
+     * \return the slot of the routine played by autonomous
+     */
+    std::uint32_t get_routine_slot();
+
     /**
      * Menu for selecting mode, competition, alliance, and starting
-     * position useing the LLEMU.
+     * position useing the LLEMU. In competition mode, the autonomous
+     * routine is picked from those on the SD card.
+     * 
+     * The calling task sleeps until an LLEMU button is pressed. Once a
+     * competition mode selection is made, the selected routine is
+     * preloaded in the background.
      */
     void menu();
 
+    /**
+     * Loads and decodes the selected routine's files for both controllers,
+     * and the pose track recorded with them, in a background task, so
+     * autonomous can start without reading the SD card. Nothing is
+     * preloaded if the catalog has no routine in the selected slot.
+     */
+    void preload_autonomous();
+
     /**
      * Robot performs a preset routine that was created by training
      * the robot using the controller recorder and playing back the
@@ -143,7 +226,9 @@ class Robot {
 
     /**
      * Trains an autonomous routine for either skills or a tournament
-     * match through using opcontrol and the controller recorder.
+     * match through using opcontrol and the controller recorder. The
+     * routine is saved to a new slot, never over an existing routine, and
+     * becomes the selected routine.
      * 
      * \param record_partner_controller - Set to true if the partner controller should be recorded.
      */
@@ -177,6 +262,44 @@ class Robot {
      * \return 1 if opcontrol task is on the ready, blocked, suspended or event lists, otherwise 0
      */
     std::int32_t opcontrol_isListed();
+
+    /**
+     * Gets the timing of the opcontrol loop since the opcontrol task last
+     * started. Its body runs from the start of the loop to the loop tick.
+     * 
+     * \return the opcontrol loop timing
+     */
+    umbc::LoopTiming& get_opcontrol_timing();
+
+    /**
+     * Gets the controller the robot currently reads as the master
+     * controller, physical or virtual.
+     * 
+     * \return the master controller
+     */
+    umbc::Controller* get_controller_master();
+
+    /**
+     * Gets the controller the robot currently reads as the partner
+     * controller, physical or virtual.
+     * 
+     * \return the partner controller
+     */
+    umbc::Controller* get_controller_partner();
+
+    /**
+     * Gets the virtual master controller, which plays back autonomous.
+     * 
+     * \return the virtual master controller
+     */
+    umbc::VController* get_vcontroller_master();
+
+    /**
+     * Gets the virtual partner controller, which plays back autonomous.
+     * 
+     * \return the virtual partner controller
+     */
+    umbc::VController* get_vcontroller_partner();
 };
 }
 
@@ -0,0 +1,187 @@
+/**
+ * \file umbc/routinecatalog.hpp
+ *
+ * Contains the prototype for the RoutineCatalog. The RoutineCatalog indexes
+ * the autonomous routines saved on the SD card, so one can be picked from
+ * the LLEMU without reading every file in full.
+ *
+ * PROS cannot list a directory, so routines are saved in numbered slots and
+ * found by probing each slot's file name. A routine tagged "match" in slot
+ * n is saved as:
+ *
+ *   autonomous_match_<n>.bin           master controller input
+ *   autonomous_match_<n>-partner.bin   partner controller input, optional
+ *
+ * Slot 0 has no number, "autonomous_match.bin", so files saved before there
+ * were slots are slot 0.
+ */
+
+#ifndef _UMBC_ROUTINE_CATALOG_HPP_
+#define _UMBC_ROUTINE_CATALOG_HPP_
+
+#include "api.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+/**
+ * An autonomous routine found on the SD card, as described by the header
+ * of its master controller input file.
+ */
+struct Routine {
+    std::string tag;
+    std::uint32_t slot;
+    std::string file_path;
+    std::int32_t has_partner;
+    std::uint16_t poll_rate_ms;
+    controller_id_e_t controller_id;
+    std::uint32_t duration_ms;
+};
+
+class RoutineCatalog {
+
+    public:
+    static constexpr std::uint32_t max_slots = 32;
+
+    private:
+    std::string directory;
+    std::vector<Routine> routines;
+    std::int32_t scanned;
+
+    /**
+     * Reads the header of a routine's master controller input file and
+     * checks if it has a partner controller input file.
+     *
+     * \param tag
+     *      The tag of the routine.
+     *
+     * \param slot
+     *      The slot of the routine.
+     *
+     * \param routine
+     *      Set to the routine found in the slot.
+     *
+     * \return 1 if the slot holds a routine, otherwise 0
+     */
+    std::int32_t probe(const std::string& tag, std::uint32_t slot, Routine* routine);
+
+    public:
+    /**
+     * Creates an empty catalog.
+     *
+     * \param directory
+     *      The directory the routines are saved in.
+     */
+    RoutineCatalog(const char* directory = "/usd");
+
+    /**
+     * Gets the path of a routine's controller input file. The file does
+     * not have to exist.
+     *
+     * \param tag
+     *      The tag of the routine, e.g. "match".
+     *
+     * \param slot
+     *      The slot of the routine, less than max_slots.
+     *
+     * \param controller_id
+     *      The controller the input is for.
+     *
+     * \return The path of the controller input file.
+     */
+    std::string path_for(const std::string& tag, std::uint32_t slot, controller_id_e_t controller_id);
+
+    /**
+     * Replaces the index with every routine found on the SD card. Only the
+     * header of each master controller input file is read.
+     *
+     * \param tags
+     *      The tags to look for. Routines are indexed by tag in this order,
+     *      then by slot.
+     *
+     * \return The number of routines found.
+     */
+    std::uint32_t scan(const std::vector<std::string>& tags);
+
+    /**
+     * Checks if scan has been called.
+     *
+     * \return 1 if the SD card was scanned, otherwise 0
+     */
+    std::int32_t is_scanned();
+
+    /**
+     * Adds or updates one routine in the index, e.g. after it was saved,
+     * without scanning the whole SD card again. The routine is removed if
+     * its slot is empty.
+     *
+     * \param tag
+     *      The tag of the routine.
+     *
+     * \param slot
+     *      The slot of the routine.
+     *
+     * \return 1 if the slot holds a routine, otherwise 0
+     */
+    std::int32_t update(const std::string& tag, std::uint32_t slot);
+
+    /**
+     * Gets the first slot without a routine or any other file, master or
+     * partner, where a new routine can be saved without overwriting one.
+     *
+     * \param tag
+     *      The tag of the routine.
+     *
+     * \return The slot, otherwise -1 if every slot is taken.
+     */
+    std::int32_t next_slot(const std::string& tag);
+
+    /**
+     * Finds a routine in the index.
+     *
+     * \param tag
+     *      The tag of the routine.
+     *
+     * \param slot
+     *      The slot of the routine.
+     *
+     * \return The index of the routine, otherwise -1 if it is not indexed.
+     */
+    std::int32_t find(const std::string& tag, std::uint32_t slot);
+
+    /**
+     * Gets the number of routines in the index.
+     *
+     * \return The number of routines.
+     */
+    std::uint32_t size();
+
+    /**
+     * Gets a routine from the index.
+     *
+     * \param index
+     *      The index of the routine, must be less than size.
+     *
+     * \return The routine.
+     */
+    const Routine& get(std::uint32_t index);
+
+    /**
+     * Describes a routine in a line short enough for the LLEMU, e.g.
+     * "skills 3  59.8s P" for slot 3 with a partner controller.
+     *
+     * \param routine
+     *      The routine.
+     *
+     * \return The description.
+     */
+    static std::string describe(const Routine& routine);
+};
+}
+
+#endif // _UMBC_ROUTINE_CATALOG_HPP_
@@ -0,0 +1,283 @@
+/**
+ * \file umbc/telemetry.hpp
+ *
+ * Contains the prototype for the Telemetry. The Telemetry samples the state
+ * of a Robot at a fixed rate and sends it as compact binary packets, framed
+ * with COBS, over the USB serial stream or a smart port serial device.
+ *
+ * A packet is, little endian:
+ *      u8 version, u8 channels, u16 sequence, u32 time_ms, then the payload
+ *      of every channel in the channels mask in bit order, then a CRC-16 of
+ *      everything before it.
+ *
+ *      TELEMETRY_CHANNEL_CONTROLLER
+ *          u16 buttons, i8[4] axes for the master then the partner
+ *          controller.
+ *      TELEMETRY_CHANNEL_MODE
+ *          u8 competition, u8 mode, u8 competition status.
+ *      TELEMETRY_CHANNEL_PLAYBACK
+ *          u8 flags (bit 0 master virtual, bit 1 partner virtual), u32
+ *          position_ms of the master then the partner virtual controller.
+ *      TELEMETRY_CHANNEL_LOOP_TIMING
+ *          u32 iterations, u32 overruns, u32 max_lateness_us, u32
+ *          max_duration_us of the opcontrol loop.
+ *
+ * The frame is the COBS encoded packet followed by a 0 byte, so a reader
+ * can join the stream at any point. See sim/tools/telemetry.cpp for the host
+ * side decoder.
+ */
+
+#ifndef _UMBC_TELEMETRY_HPP_
+#define _UMBC_TELEMETRY_HPP_
+
+#include "controllerinput.hpp"
+#include "robot.hpp"
+#include "api.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+using namespace pros;
+using namespace std;
+
+namespace umbc {
+typedef enum {
+    TELEMETRY_CHANNEL_CONTROLLER = 0x01,
+    TELEMETRY_CHANNEL_MODE = 0x02,
+    TELEMETRY_CHANNEL_PLAYBACK = 0x04,
+    TELEMETRY_CHANNEL_LOOP_TIMING = 0x08,
+    TELEMETRY_CHANNEL_ALL = 0x0F
+} telemetry_channel;
+
+/**
+ * A decoded telemetry packet. Fields of channels missing from the packet
+ * are zero.
+ */
+struct TelemetryPacket {
+    std::uint8_t version;
+    std::uint8_t channels;
+    std::uint16_t sequence;
+    std::uint32_t time_ms;
+    ControllerInput controller_master;
+    ControllerInput controller_partner;
+    std::uint8_t competition;
+    std::uint8_t mode;
+    std::uint8_t competition_status;
+    std::uint8_t playback_flags;
+    std::uint32_t position_master_ms;
+    std::uint32_t position_partner_ms;
+    std::uint32_t iterations;
+    std::uint32_t overruns;
+    std::uint32_t max_lateness_us;
+    std::uint32_t max_duration_us;
+};
+
+class Telemetry {
+
+    private:
+    static constexpr char* t_telemetry_name = (char*)"telemetry";
+    static constexpr std::uint8_t packet_version = 1;
+    static constexpr std::uint32_t header_size = 8;
+    static constexpr std::uint32_t crc_size = 2;
+
+    Robot* robot;
+    std::uint8_t channels;
+    std::uint32_t period_ms;
+    std::uint16_t sequence;
+
+    FILE* stream;
+    std::unique_ptr<pros::Serial> serial;
+
+    std::atomic<std::uint32_t> packets;
+    std::atomic<std::uint32_t> failures;
+
+    std::unique_ptr<Task> t_telemetry;
+
+    /**
+     * Sends a packet every period until stopped.
+     *
+     * This function is intended to be used as a task, which is why it is
+     * static.
+     *
+     * \param Telemetry
+     *          The telemetry to send packets of. The type for this parameter
+     *          must be Telemetry. Intended to be 'this' pointer.
+     */
+    static void send_packets(void* Telemetry);
+
+    /**
+     * Creates the send task, if it is not already running.
+     */
+    void start_task(void);
+
+    public:
+    /**
+     * The largest packet, with every channel.
+     */
+    static constexpr std::uint32_t max_packet_size = header_size + 12 + 3 + 9 + 16 + crc_size;
+
+    /**
+     * The largest frame, with every channel.
+     */
+    static constexpr std::uint32_t max_frame_size = max_packet_size + max_packet_size / 254 + 2;
+
+    /**
+     * Creates the telemetry of a robot. Nothing is sent until it is started.
+     *
+     * \param robot
+     *      The robot to sample. Must outlive the telemetry.
+     *
+     * \param channels
+     *      The channels to send, a mask of telemetry_channel.
+     *
+     * \param period_ms
+     *      How often a packet is sent, e.g. 10 for 100 Hz.
+     */
+    Telemetry(Robot* robot, std::uint8_t channels = TELEMETRY_CHANNEL_ALL, std::uint32_t period_ms = 10);
+
+    /**
+     * Sets the channels to send from the next packet on.
+     *
+     * \param channels
+     *      A mask of telemetry_channel.
+     */
+    void set_channels(std::uint8_t channels);
+
+    /**
+     * Sets how often a packet is sent from the next packet on.
+     *
+     * \param period_ms
+     *      The period in milliseconds, at least 1.
+     */
+    void set_period(std::uint32_t period_ms);
+
+    /**
+     * Samples the robot into a packet.
+     *
+     * \param packet
+     *      The buffer the packet is written to, at least max_packet_size
+     *      bytes.
+     *
+     * \return The size of the packet in bytes.
+     */
+    std::uint32_t pack(std::uint8_t* packet);
+
+    /**
+     * Samples the robot and writes one frame to the stream or serial device.
+     *
+     * \return 1 on success, 0 if nothing was started or the write failed.
+     */
+    std::int32_t send(void);
+
+    /**
+     * Starts sending frames to a stream, by default the USB serial stream.
+     * The PROS terminal multiplexes stdout, so disable that first with
+     * serctl(SERCTL_DISABLE_COBS, NULL) to read the frames on the host, and
+     * log to the SD card, see Log::start, to keep text out of the stream.
+     *
+     * \param stream
+     *      The stream frames are written to.
+     */
+    void start(FILE* stream = stdout);
+
+    /**
+     * Starts sending frames to a serial device on a smart port.
+     *
+     * \param port
+     *      The smart port of the serial device [1-21].
+     *
+     * \param baudrate
+     *      The baudrate of the serial device.
+     */
+    void start(std::uint8_t port, std::int32_t baudrate);
+
+    /**
+     * Stops sending frames.
+     */
+    void stop(void);
+
+    /**
+     * Gets the number of frames sent since the telemetry was created.
+     *
+     * \return The number of frames.
+     */
+    std::uint32_t get_packets(void);
+
+    /**
+     * Gets the number of frames that could not be written in full since the
+     * telemetry was created.
+     *
+     * \return The number of failed frames.
+     */
+    std::uint32_t get_failures(void);
+
+    /**
+     * Computes the CRC-16/CCITT-FALSE of a buffer.
+     *
+     * \param data
+     *      The buffer.
+     *
+     * \param size
+     *      The number of bytes in the buffer.
+     *
+     * \return The CRC.
+     */
+    static std::uint16_t crc16(const std::uint8_t* data, std::uint32_t size);
+
+    /**
+     * Frames a packet with COBS, so it contains no 0 bytes, and ends it with
+     * a 0 byte.
+     *
+     * \param packet
+     *      The packet.
+     *
+     * \param size
+     *      The size of the packet in bytes.
+     *
+     * \param frame
+     *      The buffer the frame is written to, at least
+     *      size + size / 254 + 2 bytes.
+     *
+     * \return The size of the frame in bytes, including the trailing 0.
+     */
+    static std::uint32_t encode(const std::uint8_t* packet, std::uint32_t size, std::uint8_t* frame);
+
+    /**
+     * Decodes a COBS frame back into its packet.
+     *
+     * \param frame
+     *      The frame, without its trailing 0.
+     *
+     * \param size
+     *      The size of the frame in bytes.
+     *
+     * \param packet
+     *      The buffer the packet is written to, at least size bytes.
+     *
+     * \return The size of the packet in bytes, or -1 if the frame is not
+     * valid COBS.
+     */
+    static std::int32_t decode(const std::uint8_t* frame, std::uint32_t size, std::uint8_t* packet);
+
+    /**
+     * Reads the fields of a packet, checking its CRC.
+     *
+     * \param packet
+     *      The packet, from decode.
+     *
+     * \param size
+     *      The size of the packet in bytes.
+     *
+     * \param telemetry_packet
+     *      The fields of the packet.
+     *
+     * \return 1 on success, 0 if the packet is truncated, corrupt or of
+     * another version.
+     */
+    static std::int32_t parse(const std::uint8_t* packet, std::uint32_t size, TelemetryPacket* telemetry_packet);
+};
+}
+
+#endif // _UMBC_TELEMETRY_HPP_
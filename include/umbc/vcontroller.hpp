@@ -9,31 +9,62 @@
 #ifndef _UMBC_V_CONTROLLER_HPP_
 #define _UMBC_V_CONTROLLER_HPP_
 
+#include "atomiccontrollerinput.hpp"
 #include "controller.hpp"
 #include "controllerinput.hpp"
+#include "edgedetector.hpp"
+#include "looptiming.hpp"
+#include "posecorrection.hpp"
+#include "recording.hpp"
 #include "api.h"
 
+#include <atomic>
 #include <cstdint>
-#include <queue>
-#include <map>
+#include <memory>
 using namespace pros;
 using namespace std;
 
 namespace umbc {
+typedef enum {
+	PLAYBACK_WALL_CLOCK = 0,
+	PLAYBACK_LOCKSTEP = 1,
+	PLAYBACK_CATCH_UP = 2
+} playback_policy;
+
 class VController : public umbc::Controller {
 
 	private:
 	static constexpr char* t_update_controller_input_name = (char*)"vcontroller";
 
-	class Digital;
-
+	EdgeDetector digital_edges;
+	std::shared_ptr<Recording> recording;
+	std::atomic<std::uint32_t> controller_input_index;
+	std::uint32_t controller_input_event;
+	AtomicControllerInput controller_input;
 	std::uint16_t poll_rate_ms;
-	std::map<controller_digital_e_t, Digital> digitals;
-	std::queue<ControllerInput> controller_input;
+	std::atomic<std::uint32_t> position_ms;
+	std::atomic<std::int32_t> seek_ms;
+	std::atomic<float> speed;
+	// the start of the loop in the high 32 bits and the end in the low 32
+	// bits, so playback never sees a start and end from different calls
+	std::atomic<std::uint64_t> loop_ms;
+	std::atomic<std::uint32_t> resumed;
+	std::atomic<playback_policy> policy;
+	std::atomic<std::uint32_t> max_lead;
+	std::atomic<std::uint32_t> ticks;
+	std::uint32_t steps;
+	std::shared_ptr<PoseCorrection> correction;
+	LoopTiming loop_timing = LoopTiming(t_update_controller_input_name, 0);
+	// held while the update task is started, stopped or notified, since the
+	// opcontrol task ticks playback while another task starts and stops it
+	pros::Mutex t_update_mutex;
 	std::unique_ptr<Task> t_update_controller_input;
 
 	/**
-	 * Pops off the front of the controller input queue at the set poll rate.
+	 * Advances to the next controller input in the playback buffer at the set
+	 * poll rate, or at the recorded timestamps if the recording has them.
+	 * Held controller input is stored once as an event, and is expanded back
+	 * into one controller input per poll here.
 	 * 
 	 * This function is intended to be used as a task, which is why it is
 	 * static.
@@ -45,68 +76,88 @@ class VController : public umbc::Controller {
 	static void update(void* VController);
 
 	/**
-	 * Represents the state of a controller's digital channel. 
-	 */
-	class Digital {
-		
-		private:
-		std::uint8_t current : 1;
-		std::uint8_t previous : 1;
-		std::uint8_t newPress : 1;
-
-		public:
-
-		/**
-		 * Creates a new digital object and zeros all data members.
-		 */
-		Digital();
-
-		/**
-		 * Sets the current held value.
-		 * 
-		 * None zero values will be converted to 1.
-		 * 
-		 * \param 
-		 */
-		void set(std::int32_t value);
-
-		/**
-		 * Sets all data members to 0.
-		 */
-		void reset();
-
-		/**
-		 * Gets the currently held value.
-		 * 
-		 * \return The current held value.
-		 */
-		std::int32_t get();
-		
-		/**
-		 * Return's a rising edge case for the currently held value.
-		 * 
-		 * This function is not thread-safe.
-	 	 * Multiple tasks polling a single digital object may return different results under
-	 	 * the same circumstances, so only one task should call this function for any
-	 	 * given digital object.
-		 */
-		std::int32_t get_new_press();
-	};
+	 * Gets the controller input in the recording at the given time since
+	 * playback started. Buttons are taken from the nearest frame and analog
+	 * axes are linearly interpolated between the frames before and after.
+	 * 
+	 * Playback only moves forward, so the frames before the current frame
+	 * are not searched.
+	 * 
+	 * \param time_ms
+	 * 			The time since playback started in milliseconds.
+	 * 
+	 * \param controller_input
+	 * 			Set to the resampled controller input.
+	 */
+	void resample(std::uint32_t time_ms, ControllerInput& controller_input);
+
+	/**
+	 * Moves playback to the frame recorded at or before the given time, in
+	 * either direction.
+	 * 
+	 * \param time_ms
+	 * 			The time in the recording in milliseconds. Playback ends if
+	 * 			this is past the end of the recording.
+	 * 
+	 * \return The controller input of the frame.
+	 */
+	ControllerInput jump(std::uint32_t time_ms);
+
+	/**
+	 * Waits until playback should take its next step, according to the
+	 * playback policy.
+	 * 
+	 * \param now
+	 * 			The time the last step was taken, updated to the time this
+	 * 			step is taken.
+	 * 
+	 * \param delay_ms
+	 * 			How long after the last step the next step is due by the
+	 * 			wall clock.
+	 */
+	void wait_for_step(std::uint32_t* now, std::uint32_t delay_ms);
+
+	/**
+	 * Checks if the update controller input task is running or paused.
+	 * 
+	 * \return 1 if the task exists and has not completed, otherwise 0
+	 */
+	std::int32_t is_playing(void);
+
+	/**
+	 * Checks if the update controller input task is running or paused. The
+	 * caller must hold t_update_mutex.
+	 * 
+	 * \return 1 if the task exists and has not completed, otherwise 0
+	 */
+	std::int32_t is_update_running(void);
+
+	/**
+	 * Notifies the update controller input task if it is running or paused.
+	 */
+	void notify_update(void);
 
     public:
 
 	/**
 	 * Creates a virtual controller object and initializes all data members.
+	 * 
+	 * \param poll_rate_ms
+	 * 			The rate in milliseconds the controller input is updated at
+	 * 			during playback. If 0, every recorded frame is played back at
+	 * 			the rate it was recorded at. Otherwise the recording is
+	 * 			resampled, so it can be recorded at a finer rate than it is
+	 * 			played back at, or the other way around.
 	 */
-	VController();
+	VController(std::uint16_t poll_rate_ms = 0);
 
     /**
 	 * Checks if the controller is connected.
 	 *
-	 * Connected for the virtual controller means that the controller input queue
-	 * is not empty.
+	 * Connected for the virtual controller means that playback has not
+	 * reached the end of the controller input buffer.
 	 *
-	 * \return 0 if the controller input queue is empty, otherwise 1
+	 * \return 0 if there is no controller input left to play, otherwise 1
 	 */
 	std::int32_t is_connected(void);
 
@@ -187,6 +238,14 @@ class VController : public umbc::Controller {
 	 */
 	std::int32_t get_digital_new_press(controller_digital_e_t button);
 
+	/**
+	 * Gets the state of every analog and digital channel in one call.
+	 *
+	 * \return The controller input currently being played back. If there is
+	 * no controller input left to play, then every channel is 0
+	 */
+	ControllerInput snapshot(void);
+
 	/**
 	 * Sets text to the controller LCD screen.
 	 *
@@ -264,11 +323,8 @@ class VController : public umbc::Controller {
 	std::int32_t clear(void);
 
 	/**
-	 * Reads a controller input file, saves the poll rate, and loads the
-	 * controller inputs from the file into a queue.
-	 * 
-	 * If the poll rate in the file is zero, this function will fail
-	 * since zero is an illegal poll rate value.
+	 * Reads a controller input file and loads it into the playback buffer.
+	 * See Recording::load.
 	 * 
 	 * \param file_path
 	 * 			The path for the file to retrieve the poll rate and load
@@ -280,26 +336,125 @@ class VController : public umbc::Controller {
 	std::int32_t load(std::string& file_path);
 
 	/**
-	 * Creates a seperate task that pops off the front of the controller
-	 * input queue at the set poll rate.
+	 * Uses an already loaded recording as the playback buffer, e.g. one
+	 * preloaded by a RecordingCache. The recording is shared, not copied.
+	 * 
+	 * \param recording
+	 * 			The recording to play back.
+	 * 
+	 * \return 1 on success, 0 if the recording is null or empty.
+	 */
+	std::int32_t load(std::shared_ptr<Recording> recording);
+
+	/**
+	 * Creates a seperate task that advances through the controller input
+	 * buffer at the set poll rate.
 	 */
 	void start(void);
 
 	/**
-	 * Pauses popping off the front of the controller input queue at the
-	 * set poll rate by suspending the update controller input task.
+	 * Moves playback to a time in the recording. The recording is kept
+	 * whole during playback, so this can move backwards as well as forwards.
+	 * If playback is running, the seek happens on its next update.
+	 * 
+	 * \param position_ms
+	 * 			The time in the recording in milliseconds.
+	 */
+	void seek(std::uint32_t position_ms);
+
+	/**
+	 * Gets the playback position.
+	 * 
+	 * \return The time in the recording being played back in milliseconds.
+	 */
+	std::uint32_t get_position(void);
+
+	/**
+	 * Sets how fast the recording is played back, e.g. 0.5 for half speed or
+	 * 2 for double speed.
+	 * 
+	 * \param speed
+	 * 			The playback speed, must be greater than 0.
+	 */
+	void set_speed(float speed);
+
+	/**
+	 * Loops playback over part of the recording. Once the position reaches
+	 * the end of the loop, playback continues from the start of the loop.
+	 * 
+	 * \param start_ms
+	 * 			The time in the recording the loop starts at in milliseconds.
+	 * 
+	 * \param end_ms
+	 * 			The time in the recording the loop ends at in milliseconds. If
+	 * 			this is not after start_ms, looping is turned off.
+	 */
+	void set_loop(std::uint32_t start_ms, std::uint32_t end_ms);
+
+	/**
+	 * Sets how playback keeps time with the task reading the controller.
+	 * 
+	 * PLAYBACK_WALL_CLOCK steps at the poll rate no matter what, so a reader
+	 * that overruns its loop misses controller input.
+	 * 
+	 * PLAYBACK_LOCKSTEP takes exactly one step each time tick is called, so
+	 * the reader sees every step once no matter how long its loop takes.
+	 * 
+	 * PLAYBACK_CATCH_UP steps at the poll rate, but never more than max_lead
+	 * steps ahead of tick. While the reader is behind, playback waits for it
+	 * and the time spent waiting is dropped from the timeline, so an overrun
+	 * delays the rest of the playback instead of skipping controller input.
+	 * 
+	 * A step is one poll at the poll rate, or one recorded frame if the poll
+	 * rate is 0. For the last two policies the poll rate should be the
+	 * reader's period, otherwise a recording made at a finer rate than the
+	 * reader plays back slower than it was recorded.
+	 * 
+	 * \param policy
+	 * 			The playback policy.
+	 * 
+	 * \param max_lead
+	 * 			For PLAYBACK_CATCH_UP, how many steps playback may be ahead of
+	 * 			the reader.
+	 */
+	void set_policy(playback_policy policy, std::uint32_t max_lead = 1);
+
+	/**
+	 * Plays back closed loop. Each frame is corrected towards the pose that
+	 * was recorded with it before it is published, see PoseCorrection. The
+	 * correction is kept until it is replaced or playback is stopped.
+	 * 
+	 * Playback does not set the odometry, call PoseCorrection::start before
+	 * start.
+	 * 
+	 * \param correction
+	 * 			The correction to apply, or nullptr to play back open loop.
+	 */
+	void set_correction(std::shared_ptr<PoseCorrection> correction);
+
+	/**
+	 * Marks one loop of the task reading the controller, e.g. once per
+	 * opcontrol loop. Only used by PLAYBACK_LOCKSTEP and PLAYBACK_CATCH_UP.
+	 */
+	void tick(void);
+
+	/**
+	 * Pauses advancing through the controller input buffer at the set poll
+	 * rate by suspending the update controller input task. The playback
+	 * position is kept, see resume.
 	 */
 	void pause(void);
 
 	/**
-	 * Resumes popping off the front of the controller input queue at the
-	 * set poll rate by resuming the update controller input task.
+	 * Resumes advancing through the controller input buffer at the set poll
+	 * rate by resuming the update controller input task. Playback continues
+	 * from where it was paused rather than skipping the paused time.
 	 */
 	void resume(void);
 
 	/**
 	 * Deletes the update controller input task and clears the the controller
-	 * input queue.
+	 * input buffer and pose correction.
 	 */
 	void stop(void);
 
@@ -307,6 +462,15 @@ class VController : public umbc::Controller {
 	 * Wait for the update controller input task to complete.
 	 */
 	void wait_till_complete(void);
+
+	/**
+	 * Gets the timing of the update controller input task's loop since
+	 * playback last started. Its period is the poll rate, or the poll rate
+	 * of the recording when following the recorded timeline.
+	 * 
+	 * \return The loop timing.
+	 */
+	LoopTiming& get_loop_timing(void);
 };
 }
 
@@ -0,0 +1,188 @@
+/**
+ * \file bench.cpp
+ *
+ * Contains the benchmark runner. Every benchmark runs on a new kernel with
+ * an empty SD card, with the umbc log discarded so printing it is not
+ * timed.
+ *
+ * Usage: umbc_bench [name]
+ *      name    only run the benchmarks whose name contains name
+ */
+
+#include "bench.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+constexpr std::uint64_t min_time_ns = 200000000;
+constexpr std::uint64_t max_wall_time_ns = 2000000000;
+constexpr std::uint32_t min_iterations = 3;
+constexpr std::uint32_t max_iterations = 1000000;
+
+struct benchmark {
+    const char* name;
+    bench::bench_fn fn;
+};
+
+std::vector<benchmark>& benchmarks() {
+    static std::vector<benchmark> registered;
+    return registered;
+}
+
+std::atomic<std::int32_t> counting(0);
+std::atomic<std::uint64_t> allocated_bytes(0);
+std::atomic<std::uint64_t> allocations(0);
+volatile std::int32_t sink;
+
+/**
+ * A stream buffer that discards everything written to it.
+ */
+class NullBuffer : public std::streambuf {
+    protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+void* allocate(std::size_t size) {
+
+    if (counting.load(std::memory_order_relaxed)) {
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return std::malloc(0 == size ? 1 : size);
+}
+}
+
+void* operator new(std::size_t size) {
+
+    void* p = allocate(size);
+    if (nullptr == p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void bench::measure(const char* name, std::uint32_t frames, std::function<void(void)> operation,
+    std::function<void(void)> setup) {
+
+    std::chrono::steady_clock::time_point began = std::chrono::steady_clock::now();
+    std::uint64_t elapsed_ns = 0;
+    std::uint64_t wall_time_ns = 0;
+    std::uint32_t iterations = 0;
+
+    allocated_bytes = 0;
+    allocations = 0;
+
+    // an expensive setup limits how often the operation is run
+    while (min_iterations > iterations
+        || (min_time_ns > elapsed_ns && max_wall_time_ns > wall_time_ns && max_iterations > iterations)) {
+
+        if (setup) {
+            setup();
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        counting = 1;
+        operation();
+        counting = 0;
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+        // only the cost of queueing log messages is measured
+        umbc::Log::flush();
+
+        elapsed_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        wall_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - began).count();
+        iterations++;
+    }
+
+    double ns_per_op = (double)elapsed_ns / iterations;
+    std::printf("%-36s %9u %14.0f %10.1f %12.0f %10.1f\n", name, iterations, ns_per_op,
+        (0 < frames) ? ns_per_op / frames : 0.0, (double)allocated_bytes / iterations,
+        (double)allocations / iterations);
+    std::fflush(stdout);
+}
+
+void bench::keep(std::int32_t value) {
+    sink = value;
+}
+
+std::int32_t bench::add_bench(const char* name, bench_fn fn) {
+    benchmarks().push_back({name, fn});
+    return 0;
+}
+
+int main(int argc, char** argv) {
+
+    std::string filter = (1 < argc) ? argv[1] : "";
+    NullBuffer null_buffer;
+
+    if (!sim::mount_usd()) {
+        return 2;
+    }
+
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(&null_buffer);
+
+    std::printf("%-36s %9s %14s %10s %12s %10s\n", "benchmark", "runs", "ns/op", "ns/frame", "bytes/op",
+        "allocs/op");
+
+    for (const benchmark& b : benchmarks()) {
+
+        if (!filter.empty() && std::string::npos == std::string(b.name).find(filter)) {
+            continue;
+        }
+
+        sim::empty_usd();
+        sim::reset();
+        sim::set_time_limit(UINT32_MAX);
+        sim::reset_devices();
+        sim::trace().clear();
+
+        b.fn();
+    }
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+    sim::unmount_usd();
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+/**
+ * \file input.cpp
+ *
+ * Contains the benchmarks of the input pipeline: what the recorder and the
+ * virtual controller cost per controller input, for the length of a match
+ * and of a skills run.
+ */
+
+#include "bench.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+constexpr std::uint16_t poll_rate_ms = 5;
+constexpr std::uint8_t analog_deadband = 2;
+constexpr std::uint32_t match_ms = 45000;
+constexpr std::uint32_t skills_ms = 60000;
+constexpr std::uint32_t get_set_frames = 1000;
+
+/**
+ * A driver sweeping the sticks and pressing a button every few hundred
+ * milliseconds, so most frames differ from the one before.
+ */
+ControllerInput driver(std::uint32_t time_ms) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs];
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        axes[i] = std::lround(127 * std::sin(2 * M_PI * time_ms / (1500.0 + 400 * i)));
+    }
+    return ControllerInput((1 << ((time_ms / 300) % ControllerInput::number_of_digitals)), axes);
+}
+
+void record(ControllerRecorder& recorder, std::uint32_t duration_ms) {
+
+    recorder.start();
+    pros::Task::delay(duration_ms);
+    recorder.stop();
+}
+
+/**
+ * Records the driver for a run and saves it.
+ *
+ * \return The saved recording.
+ */
+std::shared_ptr<Recording> record_file(const char* file_path, std::uint32_t duration_ms) {
+
+    PController controller(E_CONTROLLER_MASTER);
+    ControllerRecorder recorder(&controller, poll_rate_ms, E_CONTROLLER_MASTER, INPUT_ENCODING_RLE,
+        INPUT_FLAG_TIMESTAMPS, analog_deadband);
+    std::shared_ptr<Recording> recording = std::make_shared<Recording>();
+
+    record(recorder, duration_ms);
+    recorder.save(file_path);
+    recording->load(file_path);
+
+    return recording;
+}
+
+void bench_load(const char* name, const char* file_path, std::uint32_t duration_ms) {
+
+    std::shared_ptr<Recording> recording = record_file(file_path, duration_ms);
+    VController vcontroller;
+
+    bench::measure(name, recording->size(), [&]() { bench::keep(vcontroller.load(file_path)); });
+}
+
+void bench_save(const char* name, const char* file_path, std::uint32_t duration_ms) {
+
+    PController controller(E_CONTROLLER_MASTER);
+    ControllerRecorder recorder(&controller, poll_rate_ms, E_CONTROLLER_MASTER, INPUT_ENCODING_RLE,
+        INPUT_FLAG_TIMESTAMPS, analog_deadband);
+    std::int32_t frames = 0;
+
+    // saving clears the recorder, so every save needs a new run
+    bench::measure(name, duration_ms / poll_rate_ms,
+        [&]() { frames = recorder.save(file_path); },
+        [&]() { record(recorder, duration_ms); });
+    bench::keep(frames);
+}
+
+/**
+ * Plays a recording back with nothing reading it. The kernel switches
+ * between the playback task and the benchmark are timed too, see
+ * sim_kernel_delay_until.
+ */
+void bench_update(const char* name, std::uint16_t vcontroller_poll_rate_ms, std::uint32_t duration_ms) {
+
+    std::shared_ptr<Recording> recording = record_file("/usd/update.bin", duration_ms);
+    VController vcontroller(vcontroller_poll_rate_ms);
+    std::uint32_t frames = vcontroller_poll_rate_ms ? duration_ms / vcontroller_poll_rate_ms : recording->size();
+
+    bench::measure(name, frames,
+        [&]() {
+            vcontroller.start();
+            vcontroller.wait_till_complete();
+        },
+        [&]() { vcontroller.load(recording); });
+}
+
+std::uint32_t kernel_steps;
+
+void step(void* /* parameters */) {
+
+    std::uint32_t now = pros::millis();
+
+    for (std::uint32_t i = 0; i < kernel_steps; i++) {
+        pros::Task::delay_until(&now, poll_rate_ms);
+    }
+}
+}
+
+SIM_BENCH(controller_input_get_set) {
+
+    ControllerInput controller_input;
+
+    bench::measure("controller_input_get_set", get_set_frames, [&]() {
+        for (std::uint32_t i = 0; i < get_set_frames; i++) {
+            controller_analog_e_t channel = (controller_analog_e_t)(i % ControllerInput::number_of_analogs);
+            controller_digital_e_t button = (controller_digital_e_t)(E_CONTROLLER_DIGITAL_L1
+                + i % ControllerInput::number_of_digitals);
+
+            controller_input.set_analog(channel, (std::int32_t)(i % 255) - 127);
+            controller_input.set_digital(button, i & 1);
+            bench::keep(controller_input.get_analog(channel) + controller_input.get_digital(button));
+        }
+    });
+}
+
+SIM_BENCH(vcontroller_load) {
+
+    sim::set_controller(E_CONTROLLER_MASTER, driver);
+
+    bench_load("vcontroller_load_45s", "/usd/match.bin", match_ms);
+    bench_load("vcontroller_load_60s", "/usd/skills.bin", skills_ms);
+}
+
+SIM_BENCH(controller_recorder_save) {
+
+    sim::set_controller(E_CONTROLLER_MASTER, driver);
+
+    bench_save("controller_recorder_save_45s", "/usd/match.bin", match_ms);
+    bench_save("controller_recorder_save_60s", "/usd/skills.bin", skills_ms);
+}
+
+SIM_BENCH(edge_detector_update) {
+
+    sim::set_controller(E_CONTROLLER_MASTER, driver);
+
+    std::shared_ptr<Recording> recording = record_file("/usd/match.bin", match_ms);
+    std::vector<std::uint16_t> buttons;
+    EdgeDetector edge_detector;
+
+    for (std::uint32_t i = 0; i < recording->size(); i++) {
+        buttons.push_back(recording->get_frame(i).buttons());
+    }
+
+    bench::measure("edge_detector_update_45s", buttons.size(), [&]() {
+        edge_detector.reset();
+        for (std::uint16_t frame : buttons) {
+            edge_detector.update(frame);
+            bench::keep(edge_detector.get_new_presses());
+        }
+    });
+}
+
+SIM_BENCH(vcontroller_update) {
+
+    sim::set_controller(E_CONTROLLER_MASTER, driver);
+
+    bench_update("vcontroller_update_45s", 0, match_ms);
+    bench_update("vcontroller_update_resample_45s", 10, match_ms);
+}
+
+SIM_BENCH(sim_kernel_delay_until) {
+
+    // what playback costs without the update body, to subtract from the
+    // vcontroller_update benchmarks
+    kernel_steps = match_ms / poll_rate_ms;
+    bench::measure("sim_kernel_delay_until_45s", kernel_steps, []() {
+        Task task(step, nullptr, "step");
+        task.join();
+    });
+}
@@ -0,0 +1,36 @@
+/**
+ * \file log.cpp
+ *
+ * Contains the benchmarks of the Log: what a logging task pays per message.
+ * The ring buffer is drained between runs, so no message is dropped.
+ */
+
+#include "bench.hpp"
+
+#include <cstdint>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+constexpr std::uint32_t number_of_messages = 100;
+}
+
+SIM_BENCH(log_write) {
+
+    std::string file_path = "/usd/autonomous_match.bin";
+
+    bench::measure("log_write_literal", number_of_messages, [&]() {
+        for (std::uint32_t i = 0; i < number_of_messages; i++) {
+            INFO("recording controller input...");
+        }
+    });
+
+    bench::measure("log_write_arguments", number_of_messages, [&]() {
+        for (std::uint32_t i = 0; i < number_of_messages; i++) {
+            INFO("%u bytes of controller input written to %s", i, file_path);
+        }
+    });
+}
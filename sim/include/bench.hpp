@@ -0,0 +1,68 @@
+/**
+ * \file bench.hpp
+ *
+ * Contains the prototypes for the host microbenchmarks. Benchmarks run on
+ * the simulated kernel like the tests, see sim.hpp, but are timed on the
+ * host clock. Every heap allocation made while an operation is timed is
+ * counted.
+ *
+ * Host numbers are not the brain's numbers. They are for comparing one
+ * build against another, to catch a regression before it reaches the robot.
+ */
+
+#ifndef _BENCH_HPP_
+#define _BENCH_HPP_
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <functional>
+
+namespace bench {
+typedef void (*bench_fn)(void);
+
+/**
+ * Times an operation, running it until it has run for long enough to give
+ * a stable average, and prints one line of results.
+ *
+ * \param name
+ *      The name printed for the operation.
+ *
+ * \param frames
+ *      The number of controller inputs the operation handles, used for the
+ *      nanoseconds per frame. 0 if it does not handle frames.
+ *
+ * \param operation
+ *      The operation to time.
+ *
+ * \param setup
+ *      Called before every run of the operation and not timed, e.g. for an
+ *      operation that consumes its input. Empty if there is nothing to set
+ *      up.
+ */
+void measure(const char* name, std::uint32_t frames, std::function<void(void)> operation,
+    std::function<void(void)> setup = nullptr);
+
+/**
+ * Keeps the compiler from optimizing away a value that is only computed to
+ * be timed.
+ *
+ * \param value
+ *      The value.
+ */
+void keep(std::int32_t value);
+
+/**
+ * Registers a benchmark, see SIM_BENCH.
+ *
+ * \return Always 0
+ */
+std::int32_t add_bench(const char* name, bench_fn fn);
+}
+
+#define SIM_BENCH(name) \
+    static void name(void); \
+    static std::int32_t name##_registered = bench::add_bench(#name, name); \
+    static void name(void)
+
+#endif // _BENCH_HPP_
@@ -0,0 +1,217 @@
+/**
+ * \file sim.hpp
+ *
+ * Contains the prototypes for the host simulation harness. The harness
+ * builds the umbc sources for Linux against stand-ins for the PROS kernel
+ * and devices, so Robot::train_autonomous and Robot::autonomous can be run
+ * without a brain or a field.
+ *
+ * Tasks are real threads, but only one runs at a time. The highest priority
+ * ready task runs until it blocks, and the simulated clock only moves when
+ * every task is blocked, straight to the next wake up. Runs are therefore
+ * deterministic and take milliseconds, no matter how much simulated time
+ * passes.
+ *
+ * Paths starting with "/usd/" are opened in a temporary directory that is
+ * emptied before every test.
+ */
+
+#ifndef _SIM_HPP_
+#define _SIM_HPP_
+
+#include "umbc.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sim {
+typedef std::function<umbc::ControllerInput(std::uint32_t time_ms)> controller_script;
+typedef std::function<std::uint8_t(std::uint32_t time_ms)> lcd_script;
+typedef void (*test_fn)(void);
+
+/**
+ * What opcontrol read from both controllers in one of its loops.
+ */
+struct sample {
+    std::uint32_t time_ms;
+    umbc::ControllerInput master;
+    umbc::ControllerInput partner;
+};
+
+/**
+ * Starts a new simulated kernel with the calling thread as its only task,
+ * at time 0. Tasks left over from the previous kernel never run again.
+ */
+void reset(void);
+
+/**
+ * Gets the simulated time.
+ *
+ * \return The milliseconds since the kernel was reset.
+ */
+std::uint32_t millis(void);
+
+/**
+ * Sets the longest a test may run in simulated time, so a task waiting on
+ * playback that never ends fails the test run instead of hanging it.
+ *
+ * \param limit_ms
+ *      The limit in milliseconds.
+ */
+void set_time_limit(std::uint32_t limit_ms);
+
+/**
+ * Sets what a physical controller reports.
+ *
+ * \param id
+ *      The controller.
+ *
+ * \param script
+ *      Called with the simulated time whenever the controller is read.
+ *      Empty to report neutral controller input.
+ */
+void set_controller(controller_id_e_t id, controller_script script);
+
+/**
+ * Connects or disconnects a physical controller.
+ *
+ * \param id
+ *      The controller.
+ *
+ * \param connected
+ *      1 if the controller is connected, otherwise 0
+ */
+void set_connected(controller_id_e_t id, std::int32_t connected);
+
+/**
+ * Sets which LLEMU buttons are pressed.
+ *
+ * \param script
+ *      Called with the simulated time whenever the buttons are read, returns
+ *      a mask of LCD_BTN_LEFT, LCD_BTN_CENTER and LCD_BTN_RIGHT. Empty if no
+ *      button is pressed.
+ */
+void set_lcd_buttons(lcd_script script);
+
+/**
+ * Presses LLEMU buttons one after another, each held for a while and then
+ * released for as long.
+ *
+ * \param buttons
+ *      The buttons to press in order, LCD_BTN_LEFT, LCD_BTN_CENTER or
+ *      LCD_BTN_RIGHT.
+ *
+ * \param start_ms
+ *      When the first button is pressed.
+ *
+ * \param hold_ms
+ *      How long each button is held.
+ */
+void press_lcd_buttons(const std::vector<std::uint8_t>& buttons, std::uint32_t start_ms = 100,
+    std::uint32_t hold_ms = 100);
+
+/**
+ * Gets a line of the LLEMU.
+ *
+ * \param line
+ *      The line [0-7].
+ *
+ * \return The text on the line.
+ */
+std::string get_lcd_line(std::int16_t line);
+
+/**
+ * Inserts or removes the SD card. Without an SD card, opening any path on
+ * "/usd/" fails.
+ *
+ * \param installed
+ *      1 if the SD card is inserted, otherwise 0
+ */
+void set_usd_installed(std::int32_t installed);
+
+/**
+ * Sets what the field control reports, see pros::competition::get_status.
+ *
+ * \param status
+ *      The COMPETITION_* bits, 0 for an enabled robot in opcontrol without
+ *      field control.
+ */
+void set_competition_status(std::uint8_t status);
+
+/**
+ * Maps a path on the brain to the path it is stored at on the host.
+ *
+ * \param path
+ *      The path on the brain, e.g. "/usd/autonomous_match.bin".
+ *
+ * \return The host path for paths on "/usd/", otherwise path unchanged.
+ */
+std::string host_path(const std::string& path);
+
+/**
+ * Gets what opcontrol read from the controllers in every loop since the
+ * test started. The simulated opcontrol only reads the controllers, so this
+ * is what a drivetrain would have been driven with.
+ *
+ * \return The samples, oldest first. Can be cleared between runs.
+ */
+std::vector<sample>& trace(void);
+
+/**
+ * Disconnects the scripts from both controllers and the LLEMU, connects both
+ * controllers, shuts down the LLEMU and inserts the SD card.
+ */
+void reset_devices(void);
+
+/**
+ * Creates the temporary directory the SD card is stored in.
+ *
+ * \return 1 on success, 0 otherwise.
+ */
+std::int32_t mount_usd(void);
+
+/**
+ * Deletes every file on the SD card.
+ */
+void empty_usd(void);
+
+/**
+ * Deletes the temporary directory the SD card is stored in.
+ */
+void unmount_usd(void);
+
+/**
+ * Checks if the SD card is inserted, see set_usd_installed.
+ *
+ * \return 1 if the SD card is inserted, otherwise 0
+ */
+std::int32_t is_usd_installed(void);
+
+/**
+ * Registers a test, see SIM_TEST.
+ *
+ * \return Always 0
+ */
+std::int32_t add_test(const char* name, test_fn fn);
+
+/**
+ * Marks the running test as failed, see SIM_EXPECT.
+ */
+void fail(const char* file, std::int32_t line, const char* expression);
+}
+
+#define SIM_TEST(name) \
+    static void name(void); \
+    static std::int32_t name##_registered = sim::add_test(#name, name); \
+    static void name(void)
+
+#define SIM_EXPECT(expression) \
+    do { \
+        if (!(expression)) { \
+            sim::fail(__FILE__, __LINE__, #expression); \
+        } \
+    } while (0)
+
+#endif // _SIM_HPP_
@@ -0,0 +1,362 @@
+/**
+ * \file devices.cpp
+ *
+ * Contains the simulated devices: scripted controllers, field control, the
+ * LLEMU, the SD card and serial devices, which are never plugged in. Devices
+ * are read at the simulated time of the task reading them.
+ */
+
+#include "sim.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+constexpr std::uint32_t number_of_controllers = 2;
+constexpr std::uint32_t number_of_lcd_lines = 8;
+constexpr std::uint32_t number_of_lcd_buttons = 3;
+constexpr std::uint32_t lcd_poll_ms = 5;
+constexpr std::uint8_t lcd_button_masks[number_of_lcd_buttons] = {LCD_BTN_LEFT, LCD_BTN_CENTER, LCD_BTN_RIGHT};
+
+struct SimController {
+    sim::controller_script script;
+    std::int32_t connected;
+    std::uint16_t last_read;
+};
+
+SimController controllers[number_of_controllers];
+sim::lcd_script lcd_buttons;
+std::int32_t lcd_initialized = 0;
+std::string lcd_lines[number_of_lcd_lines];
+lcd_btn_cb_fn_t lcd_callbacks[number_of_lcd_buttons];
+task_t lcd_task = nullptr;
+std::int32_t usd_installed = 1;
+std::uint8_t competition_status = 0;
+
+SimController* controller(controller_id_e_t id) {
+    return (E_CONTROLLER_PARTNER == id) ? &controllers[1] : &controllers[0];
+}
+
+/**
+ * Calls the callback of every LLEMU button pressed since the last poll, as
+ * the LLEMU would from its own task.
+ */
+void poll_lcd_buttons(void* /* parameters */) {
+
+    std::uint8_t last = 0;
+
+    while (1) {
+        std::uint8_t buttons = pros::lcd::read_buttons();
+
+        for (std::uint32_t i = 0; i < number_of_lcd_buttons; i++) {
+            if ((buttons & ~last & lcd_button_masks[i]) && nullptr != lcd_callbacks[i]) {
+                lcd_callbacks[i]();
+            }
+        }
+        last = buttons;
+        pros::c::task_delay(lcd_poll_ms);
+    }
+}
+
+void register_lcd_callback(std::uint32_t button, lcd_btn_cb_fn_t cb) {
+
+    lcd_callbacks[button] = cb;
+    if (nullptr == lcd_task) {
+        lcd_task = pros::c::task_create(poll_lcd_buttons, nullptr, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT,
+            "llemu");
+    }
+}
+
+ControllerInput read(controller_id_e_t id) {
+
+    SimController* sim_controller = controller(id);
+
+    if (!sim_controller->connected || !sim_controller->script) {
+        return ControllerInput();
+    }
+    return sim_controller->script(sim::millis());
+}
+}
+
+void sim::reset_devices() {
+
+    for (std::uint32_t i = 0; i < number_of_controllers; i++) {
+        controllers[i].script = nullptr;
+        controllers[i].connected = 1;
+        controllers[i].last_read = 0;
+    }
+
+    lcd_buttons = nullptr;
+    lcd_initialized = 0;
+    for (std::uint32_t i = 0; i < number_of_lcd_lines; i++) {
+        lcd_lines[i].clear();
+    }
+    for (std::uint32_t i = 0; i < number_of_lcd_buttons; i++) {
+        lcd_callbacks[i] = nullptr;
+    }
+    lcd_task = nullptr;
+
+    usd_installed = 1;
+    competition_status = 0;
+}
+
+void sim::set_controller(controller_id_e_t id, controller_script script) {
+    controller(id)->script = script;
+}
+
+void sim::set_connected(controller_id_e_t id, std::int32_t connected) {
+    controller(id)->connected = connected;
+}
+
+void sim::set_lcd_buttons(lcd_script script) {
+    lcd_buttons = script;
+}
+
+void sim::press_lcd_buttons(const std::vector<std::uint8_t>& buttons, std::uint32_t start_ms,
+    std::uint32_t hold_ms) {
+
+    lcd_buttons = [buttons, start_ms, hold_ms](std::uint32_t time_ms) -> std::uint8_t {
+        std::uint32_t press = (time_ms - start_ms) / (2 * hold_ms);
+        std::int32_t held = hold_ms > (time_ms - start_ms) % (2 * hold_ms);
+        return (start_ms <= time_ms && buttons.size() > press && held) ? buttons[press] : 0;
+    };
+}
+
+std::string sim::get_lcd_line(std::int16_t line) {
+    return (0 <= line && number_of_lcd_lines > (std::uint32_t)line) ? lcd_lines[line] : "";
+}
+
+void sim::set_usd_installed(std::int32_t installed) {
+    usd_installed = installed;
+}
+
+std::int32_t sim::is_usd_installed() {
+    return usd_installed;
+}
+
+void sim::set_competition_status(std::uint8_t status) {
+    competition_status = status;
+}
+
+std::uint8_t pros::c::competition_get_status() {
+    return competition_status;
+}
+
+std::uint8_t pros::competition::get_status() {
+    return competition_status;
+}
+
+std::int32_t pros::c::controller_is_connected(controller_id_e_t id) {
+    return controller(id)->connected;
+}
+
+std::int32_t pros::c::controller_get_analog(controller_id_e_t id, controller_analog_e_t channel) {
+    return read(id).get_analog(channel);
+}
+
+std::int32_t pros::c::controller_get_battery_capacity(controller_id_e_t id) {
+    return controller(id)->connected ? 100 : PROS_ERR;
+}
+
+std::int32_t pros::c::controller_get_battery_level(controller_id_e_t id) {
+    return controller(id)->connected ? 100 : PROS_ERR;
+}
+
+std::int32_t pros::c::controller_get_digital(controller_id_e_t id, controller_digital_e_t button) {
+    return read(id).get_digital(button);
+}
+
+std::int32_t pros::c::controller_get_digital_new_press(controller_id_e_t id, controller_digital_e_t button) {
+
+    SimController* sim_controller = controller(id);
+    std::uint16_t mask = 1 << ControllerInput::digital_index(button);
+    std::int32_t pressed = read(id).get_digital(button);
+    std::int32_t new_press = pressed && !(sim_controller->last_read & mask);
+
+    sim_controller->last_read = pressed ? (sim_controller->last_read | mask) : (sim_controller->last_read & ~mask);
+    return new_press;
+}
+
+std::int32_t pros::c::controller_set_text(controller_id_e_t id, std::uint8_t /* line */, std::uint8_t /* col */,
+    const char* /* str */) {
+    return controller(id)->connected ? 1 : PROS_ERR;
+}
+
+std::int32_t pros::c::controller_clear_line(controller_id_e_t id, std::uint8_t /* line */) {
+    return controller(id)->connected ? 1 : PROS_ERR;
+}
+
+std::int32_t pros::c::controller_clear(controller_id_e_t id) {
+    return controller(id)->connected ? 1 : PROS_ERR;
+}
+
+std::int32_t pros::c::controller_rumble(controller_id_e_t id, const char* /* rumble_pattern */) {
+    return controller(id)->connected ? 1 : PROS_ERR;
+}
+
+std::int32_t pros::c::usd_is_installed() {
+    return usd_installed;
+}
+
+pros::Controller::Controller(controller_id_e_t id) : _id(id) {}
+
+std::int32_t pros::Controller::is_connected() {
+    return pros::c::controller_is_connected(this->_id);
+}
+
+std::int32_t pros::Controller::get_analog(controller_analog_e_t channel) {
+    return pros::c::controller_get_analog(this->_id, channel);
+}
+
+std::int32_t pros::Controller::get_battery_capacity() {
+    return pros::c::controller_get_battery_capacity(this->_id);
+}
+
+std::int32_t pros::Controller::get_battery_level() {
+    return pros::c::controller_get_battery_level(this->_id);
+}
+
+std::int32_t pros::Controller::get_digital(controller_digital_e_t button) {
+    return pros::c::controller_get_digital(this->_id, button);
+}
+
+std::int32_t pros::Controller::get_digital_new_press(controller_digital_e_t button) {
+    return pros::c::controller_get_digital_new_press(this->_id, button);
+}
+
+std::int32_t pros::Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return pros::c::controller_set_text(this->_id, line, col, str);
+}
+
+std::int32_t pros::Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return pros::c::controller_set_text(this->_id, line, col, str.c_str());
+}
+
+std::int32_t pros::Controller::clear_line(std::uint8_t line) {
+    return pros::c::controller_clear_line(this->_id, line);
+}
+
+std::int32_t pros::Controller::rumble(const char* rumble_pattern) {
+    return pros::c::controller_rumble(this->_id, rumble_pattern);
+}
+
+std::int32_t pros::Controller::clear() {
+    return pros::c::controller_clear(this->_id);
+}
+
+std::int32_t pros::usd::is_installed() {
+    return usd_installed;
+}
+
+bool pros::lcd::is_initialized() {
+    return lcd_initialized;
+}
+
+bool pros::lcd::initialize() {
+    lcd_initialized = 1;
+    return true;
+}
+
+bool pros::lcd::shutdown() {
+    lcd_initialized = 0;
+    return true;
+}
+
+bool pros::lcd::set_text(std::int16_t line, std::string text) {
+
+    if (!lcd_initialized || 0 > line || number_of_lcd_lines <= (std::uint32_t)line) {
+        return false;
+    }
+    lcd_lines[line] = text;
+    return true;
+}
+
+bool pros::lcd::clear() {
+
+    if (!lcd_initialized) {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < number_of_lcd_lines; i++) {
+        lcd_lines[i].clear();
+    }
+    return true;
+}
+
+bool pros::lcd::clear_line(std::int16_t line) {
+    return pros::lcd::set_text(line, "");
+}
+
+void pros::lcd::register_btn0_cb(lcd_btn_cb_fn_t cb) {
+    register_lcd_callback(0, cb);
+}
+
+void pros::lcd::register_btn1_cb(lcd_btn_cb_fn_t cb) {
+    register_lcd_callback(1, cb);
+}
+
+void pros::lcd::register_btn2_cb(lcd_btn_cb_fn_t cb) {
+    register_lcd_callback(2, cb);
+}
+
+std::uint8_t pros::lcd::read_buttons() {
+    return lcd_buttons ? lcd_buttons(sim::millis()) : 0;
+}
+
+// no smart port devices are simulated, so every serial device is unplugged
+pros::Serial::Serial(std::uint8_t port, std::int32_t /* baudrate */) : _port(port) {}
+
+pros::Serial::Serial(std::uint8_t port) : _port(port) {}
+
+std::int32_t pros::Serial::set_baudrate(std::int32_t /* baudrate */) const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::flush() const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::get_read_avail() const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::get_write_free() const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::uint8_t pros::Serial::get_port() const {
+    return this->_port;
+}
+
+std::int32_t pros::Serial::peek_byte() const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::read_byte() const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::read(std::uint8_t* /* buffer */, std::int32_t /* length */) const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::write_byte(std::uint8_t /* buffer */) const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
+
+std::int32_t pros::Serial::write(std::uint8_t* /* buffer */, std::int32_t /* length */) const {
+    errno = ENODEV;
+    return PROS_ERR;
+}
@@ -0,0 +1,111 @@
+/**
+ * \file harness.cpp
+ *
+ * Contains the test runner of the host simulation harness. Every test runs
+ * on a new kernel, with both controllers neutral and an empty SD card.
+ *
+ * Usage: umbc_sim [-v] [name]
+ *      -v      print the output of every test, not only of failed tests
+ *      name    only run the tests whose name contains name
+ */
+
+#include "sim.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+struct test {
+    const char* name;
+    sim::test_fn fn;
+};
+
+std::vector<test>& tests() {
+    static std::vector<test> registered;
+    return registered;
+}
+
+std::vector<std::string> failures;
+}
+
+std::int32_t sim::add_test(const char* name, test_fn fn) {
+    tests().push_back({name, fn});
+    return 0;
+}
+
+void sim::fail(const char* file, std::int32_t line, const char* expression) {
+    failures.push_back(std::string(file) + ":" + std::to_string(line) + ": expected " + expression);
+}
+
+int main(int argc, char** argv) {
+
+    std::int32_t verbose = 0;
+    std::string filter;
+
+    for (std::int32_t i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if ("-v" == arg) {
+            verbose = 1;
+        } else {
+            filter = arg;
+        }
+    }
+
+    if (!sim::mount_usd()) {
+        return 2;
+    }
+
+    std::uint32_t run = 0;
+    std::uint32_t failed = 0;
+
+    for (const test& t : tests()) {
+
+        if (!filter.empty() && std::string::npos == std::string(t.name).find(filter)) {
+            continue;
+        }
+
+        sim::empty_usd();
+        sim::reset();
+        sim::reset_devices();
+        sim::trace().clear();
+        failures.clear();
+
+        std::ostringstream output;
+        std::streambuf* cout_buffer = std::cout.rdbuf(output.rdbuf());
+        std::streambuf* cerr_buffer = std::cerr.rdbuf(output.rdbuf());
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        umbc::Log::start();
+        t.fn();
+        umbc::Log::stop();
+
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout.rdbuf(cout_buffer);
+        std::cerr.rdbuf(cerr_buffer);
+
+        run++;
+        failed += !failures.empty();
+
+        std::printf("%s %s (%u ms simulated in %lld ms)\n", failures.empty() ? "PASS" : "FAIL", t.name,
+            sim::millis(), (long long)std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+        if (verbose || !failures.empty()) {
+            std::fputs(output.str().c_str(), stdout);
+        }
+        for (const std::string& failure : failures) {
+            std::printf("  %s\n", failure.c_str());
+        }
+    }
+
+    sim::unmount_usd();
+    std::printf("%u of %u tests passed\n", run - failed, run);
+
+    return (0 == failed) ? 0 : 1;
+}
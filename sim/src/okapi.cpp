@@ -0,0 +1,121 @@
+/**
+ * \file okapi.cpp
+ *
+ * Contains the parts of okapi the umbc sources link against, as okapi is
+ * only built for the brain. Its headers create a default logger when
+ * DefaultLoggerInitializer::count starts at 0; it starts at 1 here, so
+ * okapi never logs, but the logger and its timer must still link.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+
+using namespace okapi;
+
+namespace okapi {
+int DefaultLoggerInitializer::count = 1;
+std::shared_ptr<Logger> defaultLogger;
+}
+
+okapi::AbstractTimer::AbstractTimer(QTime ifirstCalled)
+    : firstCalled(ifirstCalled), lastCalled(ifirstCalled), mark(ifirstCalled), hardMark(0 * millisecond),
+      repeatMark(0 * millisecond) {}
+
+okapi::AbstractTimer::~AbstractTimer() = default;
+
+QTime okapi::AbstractTimer::getDt() {
+
+    QTime now = this->millis();
+    QTime dt = now - this->lastCalled;
+
+    this->lastCalled = now;
+    return dt;
+}
+
+QTime okapi::AbstractTimer::readDt() const {
+    return this->millis() - this->lastCalled;
+}
+
+QTime okapi::AbstractTimer::getStartingTime() const {
+    return this->firstCalled;
+}
+
+QTime okapi::AbstractTimer::getDtFromStart() const {
+    return this->millis() - this->firstCalled;
+}
+
+void okapi::AbstractTimer::placeMark() {
+    this->mark = this->millis();
+}
+
+QTime okapi::AbstractTimer::clearMark() {
+
+    QTime old = this->mark;
+
+    this->mark = 0 * millisecond;
+    return old;
+}
+
+void okapi::AbstractTimer::placeHardMark() {
+    if (0 * millisecond == this->hardMark) {
+        this->hardMark = this->millis();
+    }
+}
+
+QTime okapi::AbstractTimer::clearHardMark() {
+
+    QTime old = this->hardMark;
+
+    this->hardMark = 0 * millisecond;
+    return old;
+}
+
+QTime okapi::AbstractTimer::getDtFromMark() const {
+    return this->millis() - this->mark;
+}
+
+QTime okapi::AbstractTimer::getDtFromHardMark() const {
+    return (0 * millisecond == this->hardMark) ? 0 * millisecond : this->millis() - this->hardMark;
+}
+
+bool okapi::AbstractTimer::repeat(QTime time) {
+
+    if (0 * millisecond == this->repeatMark) {
+        this->repeatMark = this->millis();
+        return false;
+    }
+    if (this->millis() - this->repeatMark >= time) {
+        this->repeatMark = 0 * millisecond;
+        return true;
+    }
+    return false;
+}
+
+bool okapi::AbstractTimer::repeat(QFrequency frequency) {
+    return this->repeat(QTime(1 / frequency.convert(Hz)));
+}
+
+okapi::Timer::Timer() : AbstractTimer(pros::millis() * millisecond) {}
+
+QTime okapi::Timer::millis() const {
+    return pros::millis() * millisecond;
+}
+
+okapi::Logger::Logger() noexcept : timer(nullptr), logLevel(LogLevel::off), logfile(nullptr) {}
+
+okapi::Logger::Logger(std::unique_ptr<AbstractTimer> itimer, std::string_view /* ifileName */,
+    const LogLevel& ilevel) noexcept
+    : timer(std::move(itimer)), logLevel(ilevel), logfile(nullptr) {}
+
+okapi::Logger::Logger(std::unique_ptr<AbstractTimer> itimer, FILE* ifile, const LogLevel& ilevel) noexcept
+    : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile) {}
+
+okapi::Logger::~Logger() {
+    if (nullptr != this->logfile) {
+        std::fclose(this->logfile);
+    }
+}
@@ -0,0 +1,47 @@
+/**
+ * \file opcontrol.cpp
+ *
+ * Contains the opcontrol of the simulated robot. It drives nothing, it
+ * records what it read from both controllers in every loop, see
+ * sim::trace.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+std::vector<sim::sample> samples;
+}
+
+std::vector<sim::sample>& sim::trace() {
+    return samples;
+}
+
+void umbc::Robot::opcontrol() {
+
+    // nice names for controllers (do not edit)
+    umbc::Controller* controller_master = this->controller_master;
+    umbc::Controller* controller_partner = this->controller_partner;
+
+    while(1) {
+
+        // required loop start (do not edit)
+        this->opcontrol_begin();
+
+        // read each controller once per loop
+        ControllerInput input_master = controller_master->snapshot();
+        ControllerInput input_partner = controller_partner->snapshot();
+
+        samples.push_back({pros::millis(), input_master, input_partner});
+
+        // required loop tick and delay (do not edit)
+        this->opcontrol_tick();
+        pros::Task::delay(this->opcontrol_delay_ms);
+    }
+}
@@ -0,0 +1,751 @@
+/**
+ * \file rtos.cpp
+ *
+ * Contains the simulated kernel: the PROS task, notification, mutex,
+ * semaphore and clock API on top of threads that take turns. Exactly one task is running
+ * at any time; every other task is waiting on its own condition variable
+ * for the scheduler to hand it the kernel.
+ *
+ * Kernels are never freed. When a test resets the kernel, the threads of
+ * the old kernel stay parked on it until the process exits.
+ */
+
+#include "sim.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace pros;
+using namespace std;
+
+namespace {
+typedef enum {
+    WAIT_NONE = 0,
+    WAIT_DELAY,
+    WAIT_NOTIFY,
+    WAIT_JOIN,
+    WAIT_MUTEX,
+    WAIT_SEMAPHORE
+} wait_reason;
+
+struct Kernel;
+struct SimMutex;
+struct SimSemaphore;
+
+struct SimTask {
+    Kernel* kernel;
+    std::uint32_t id;
+    std::string name;
+    std::uint32_t priority;
+    task_state_e_t state;
+    std::uint64_t ready_sequence;
+    wait_reason waiting;
+    std::int32_t timed;
+    std::uint32_t wake_time;
+    SimTask* join_target;
+    SimMutex* mutex_target;
+    SimSemaphore* semaphore_target;
+    std::uint32_t notify_value;
+    task_fn_t function;
+    void* parameters;
+    std::condition_variable turn;
+};
+
+struct SimMutex {
+    SimTask* owner;
+};
+
+struct SimSemaphore {
+    std::uint32_t count;
+    std::uint32_t max_count;
+};
+
+struct Kernel {
+    std::mutex lock;
+    std::vector<SimTask*> tasks;
+    SimTask* current;
+    std::uint32_t now;
+    std::uint32_t time_limit;
+    std::uint64_t sequence;
+};
+
+Kernel* kernel = nullptr;
+
+void make_ready(SimTask* task) {
+
+    task->state = E_TASK_STATE_READY;
+    task->waiting = WAIT_NONE;
+    task->timed = 0;
+    task->ready_sequence = ++(task->kernel->sequence);
+}
+
+SimTask* find_ready(Kernel* k) {
+
+    SimTask* best = nullptr;
+
+    for (SimTask* task : k->tasks) {
+        if (E_TASK_STATE_READY == task->state && (nullptr == best || task->priority > best->priority
+            || (task->priority == best->priority && task->ready_sequence < best->ready_sequence))) {
+            best = task;
+        }
+    }
+    return best;
+}
+
+void dump_tasks(Kernel* k) {
+
+    for (SimTask* task : k->tasks) {
+        std::fprintf(stderr, "  %-28s state %d waiting %d\n", task->name.c_str(), task->state, task->waiting);
+    }
+}
+
+/**
+ * Picks the next task to run, moving the clock to the next wake up if no
+ * task is ready.
+ */
+SimTask* pick_next(Kernel* k) {
+
+    SimTask* next = find_ready(k);
+
+    while (nullptr == next) {
+
+        SimTask* earliest = nullptr;
+        for (SimTask* task : k->tasks) {
+            if (E_TASK_STATE_BLOCKED == task->state && task->timed
+                && (nullptr == earliest || (std::int32_t)(task->wake_time - earliest->wake_time) < 0)) {
+                earliest = task;
+            }
+        }
+
+        if (nullptr == earliest) {
+            std::fprintf(stderr, "sim: deadlock at %ums, every task is blocked forever\n", k->now);
+            dump_tasks(k);
+            std::abort();
+        }
+
+        k->now = earliest->wake_time;
+        if (k->now > k->time_limit) {
+            std::fprintf(stderr, "sim: time limit of %ums reached\n", k->time_limit);
+            dump_tasks(k);
+            std::abort();
+        }
+
+        // wake in order of wake time, then creation
+        for (SimTask* task : k->tasks) {
+            if (E_TASK_STATE_BLOCKED == task->state && task->timed && task->wake_time == k->now) {
+                make_ready(task);
+            }
+        }
+        next = find_ready(k);
+    }
+
+    return next;
+}
+
+/**
+ * Hands the kernel to the next task. The calling task must already have
+ * left the running state. Returns once the calling task is scheduled again,
+ * which is never if it was deleted.
+ */
+void switch_from(SimTask* self, std::unique_lock<std::mutex>& guard) {
+
+    Kernel* k = self->kernel;
+    SimTask* next = pick_next(k);
+
+    next->state = E_TASK_STATE_RUNNING;
+    k->current = next;
+    if (next != self) {
+        next->turn.notify_one();
+        while (k->current != self) {
+            self->turn.wait(guard);
+        }
+    }
+}
+
+/**
+ * Lets a higher priority task that just became ready run, as FreeRTOS
+ * would preempt the calling task.
+ */
+void preempt(SimTask* self, std::unique_lock<std::mutex>& guard) {
+
+    SimTask* next = find_ready(self->kernel);
+
+    if (nullptr != next && next->priority > self->priority) {
+        make_ready(self);
+        switch_from(self, guard);
+    }
+}
+
+void block(SimTask* self, wait_reason reason, std::uint32_t timeout, std::unique_lock<std::mutex>& guard) {
+
+    self->state = E_TASK_STATE_BLOCKED;
+    self->waiting = reason;
+    self->timed = TIMEOUT_MAX != timeout;
+    self->wake_time = self->kernel->now + timeout;
+    switch_from(self, guard);
+}
+
+void finish(SimTask* self, std::unique_lock<std::mutex>& guard) {
+
+    self->state = E_TASK_STATE_DELETED;
+    for (SimTask* task : self->kernel->tasks) {
+        if (E_TASK_STATE_BLOCKED == task->state && WAIT_JOIN == task->waiting && self == task->join_target) {
+            make_ready(task);
+        }
+    }
+    switch_from(self, guard);
+}
+
+void run_task(SimTask* self) {
+
+    std::unique_lock<std::mutex> guard(self->kernel->lock);
+    while (self->kernel->current != self) {
+        self->turn.wait(guard);
+    }
+    guard.unlock();
+
+    self->function(self->parameters);
+
+    guard.lock();
+    finish(self, guard);
+}
+
+SimTask* new_task(Kernel* k, const char* name, std::uint32_t priority) {
+
+    SimTask* task = new SimTask();
+
+    task->kernel = k;
+    task->id = k->tasks.size();
+    task->name = (nullptr == name) ? "" : name;
+    task->priority = priority;
+    task->state = E_TASK_STATE_READY;
+    task->ready_sequence = 0;
+    task->waiting = WAIT_NONE;
+    task->timed = 0;
+    task->wake_time = 0;
+    task->join_target = nullptr;
+    task->mutex_target = nullptr;
+    task->semaphore_target = nullptr;
+    task->notify_value = 0;
+    task->function = nullptr;
+    task->parameters = nullptr;
+    k->tasks.push_back(task);
+
+    return task;
+}
+
+SimTask* handle(task_t task) {
+    return (nullptr == task) ? kernel->current : (SimTask*)task;
+}
+}
+
+void sim::reset() {
+
+    Kernel* k = new Kernel();
+
+    k->current = nullptr;
+    k->now = 0;
+    k->time_limit = 60 * 60 * 1000;
+    k->sequence = 0;
+
+    SimTask* main_task = new_task(k, "main", TASK_PRIORITY_DEFAULT);
+    main_task->state = E_TASK_STATE_RUNNING;
+    k->current = main_task;
+
+    kernel = k;
+}
+
+std::uint32_t sim::millis() {
+    return kernel->now;
+}
+
+void sim::set_time_limit(std::uint32_t limit_ms) {
+    kernel->time_limit = limit_ms;
+}
+
+std::uint32_t pros::c::millis() {
+    return kernel->now;
+}
+
+std::uint64_t pros::c::micros() {
+    return (std::uint64_t)kernel->now * 1000;
+}
+
+task_t pros::c::task_create(task_fn_t function, void* const parameters, std::uint32_t prio,
+    const std::uint16_t /* stack_depth */, const char* const name) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimTask* task = new_task(kernel, name, prio);
+
+    task->function = function;
+    task->parameters = parameters;
+    make_ready(task);
+    std::thread(run_task, task).detach();
+
+    preempt(self, guard);
+    return (task_t)task;
+}
+
+void pros::c::task_delete(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimTask* target = handle(task);
+
+    if (target == self) {
+        finish(self, guard);
+        return;
+    }
+
+    target->state = E_TASK_STATE_DELETED;
+    target->waiting = WAIT_NONE;
+    for (SimTask* waiting : kernel->tasks) {
+        if (E_TASK_STATE_BLOCKED == waiting->state && WAIT_JOIN == waiting->waiting && target == waiting->join_target) {
+            make_ready(waiting);
+        }
+    }
+    preempt(self, guard);
+}
+
+void pros::c::task_delay(const std::uint32_t milliseconds) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+
+    if (0 == milliseconds) {
+        make_ready(self);
+        switch_from(self, guard);
+        return;
+    }
+    block(self, WAIT_DELAY, milliseconds, guard);
+}
+
+void pros::c::delay(const std::uint32_t milliseconds) {
+    task_delay(milliseconds);
+}
+
+void pros::c::task_delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    std::uint32_t wake_time = *prev_time + delta;
+
+    *prev_time = wake_time;
+    if (0 < (std::int32_t)(wake_time - kernel->now)) {
+        block(self, WAIT_DELAY, wake_time - kernel->now, guard);
+    }
+}
+
+std::uint32_t pros::c::task_get_priority(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    return handle(task)->priority;
+}
+
+void pros::c::task_set_priority(task_t task, std::uint32_t prio) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    handle(task)->priority = prio;
+    preempt(kernel->current, guard);
+}
+
+task_state_e_t pros::c::task_get_state(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    return handle(task)->state;
+}
+
+void pros::c::task_suspend(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimTask* target = handle(task);
+
+    if (E_TASK_STATE_DELETED == target->state) {
+        return;
+    }
+
+    target->state = E_TASK_STATE_SUSPENDED;
+    target->waiting = WAIT_NONE;
+    target->timed = 0;
+    if (target == self) {
+        switch_from(self, guard);
+    }
+}
+
+void pros::c::task_resume(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* target = handle(task);
+
+    if (E_TASK_STATE_SUSPENDED == target->state) {
+        make_ready(target);
+        preempt(kernel->current, guard);
+    }
+}
+
+std::uint32_t pros::c::task_get_count() {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    std::uint32_t count = 0;
+
+    for (SimTask* task : kernel->tasks) {
+        count += E_TASK_STATE_DELETED != task->state;
+    }
+    return count;
+}
+
+char* pros::c::task_get_name(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    return (char*)handle(task)->name.c_str();
+}
+
+task_t pros::c::task_get_by_name(const char* name) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+
+    for (SimTask* task : kernel->tasks) {
+        if (E_TASK_STATE_DELETED != task->state && task->name == name) {
+            return (task_t)task;
+        }
+    }
+    return nullptr;
+}
+
+task_t pros::c::task_get_current() {
+    return (task_t)kernel->current;
+}
+
+std::uint32_t pros::c::task_notify(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* target = handle(task);
+
+    target->notify_value++;
+    if (E_TASK_STATE_BLOCKED == target->state && WAIT_NOTIFY == target->waiting) {
+        make_ready(target);
+        preempt(kernel->current, guard);
+    }
+    return 1;
+}
+
+std::uint32_t pros::c::task_notify_ext(task_t task, std::uint32_t value, notify_action_e_t action,
+    std::uint32_t* prev_value) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* target = handle(task);
+
+    if (nullptr != prev_value) {
+        *prev_value = target->notify_value;
+    }
+
+    switch (action) {
+        case E_NOTIFY_ACTION_BITS:
+            target->notify_value |= value;
+            break;
+        case E_NOTIFY_ACTION_INCR:
+            target->notify_value++;
+            break;
+        case E_NOTIFY_ACTION_OWRITE:
+            target->notify_value = value;
+            break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (0 == target->notify_value) {
+                target->notify_value = value;
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (E_TASK_STATE_BLOCKED == target->state && WAIT_NOTIFY == target->waiting) {
+        make_ready(target);
+        preempt(kernel->current, guard);
+    }
+    return 1;
+}
+
+std::uint32_t pros::c::task_notify_take(bool clear_on_exit, std::uint32_t timeout) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+
+    if (0 == self->notify_value && 0 < timeout) {
+        block(self, WAIT_NOTIFY, timeout, guard);
+    }
+
+    std::uint32_t value = self->notify_value;
+    if (clear_on_exit) {
+        self->notify_value = 0;
+    } else if (0 < self->notify_value) {
+        self->notify_value--;
+    }
+    return value;
+}
+
+bool pros::c::task_notify_clear(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* target = handle(task);
+    bool was_pending = 0 != target->notify_value;
+
+    target->notify_value = 0;
+    return was_pending;
+}
+
+void pros::c::task_join(task_t task) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimTask* target = handle(task);
+
+    if (E_TASK_STATE_DELETED != target->state && target != self) {
+        self->join_target = target;
+        block(self, WAIT_JOIN, TIMEOUT_MAX, guard);
+        self->join_target = nullptr;
+    }
+}
+
+mutex_t pros::c::mutex_create() {
+
+    SimMutex* mutex = new SimMutex();
+    mutex->owner = nullptr;
+    return (mutex_t)mutex;
+}
+
+bool pros::c::mutex_take(mutex_t mutex, std::uint32_t timeout) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimMutex* target = (SimMutex*)mutex;
+
+    if (nullptr == target->owner) {
+        target->owner = self;
+        return true;
+    }
+    if (0 == timeout) {
+        return false;
+    }
+
+    // give hands the mutex straight to the task it wakes
+    self->mutex_target = target;
+    block(self, WAIT_MUTEX, timeout, guard);
+    self->mutex_target = nullptr;
+
+    return self == target->owner;
+}
+
+bool pros::c::mutex_give(mutex_t mutex) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimMutex* target = (SimMutex*)mutex;
+    SimTask* next = nullptr;
+
+    if (self != target->owner) {
+        return false;
+    }
+
+    for (SimTask* task : kernel->tasks) {
+        if (E_TASK_STATE_BLOCKED == task->state && WAIT_MUTEX == task->waiting && target == task->mutex_target
+            && (nullptr == next || task->priority > next->priority)) {
+            next = task;
+        }
+    }
+
+    target->owner = next;
+    if (nullptr != next) {
+        make_ready(next);
+        preempt(self, guard);
+    }
+    return true;
+}
+
+void pros::c::mutex_delete(mutex_t mutex) {
+    delete (SimMutex*)mutex;
+}
+
+pros::c::sem_t pros::c::sem_create(std::uint32_t max_count, std::uint32_t init_count) {
+
+    SimSemaphore* sem = new SimSemaphore();
+    sem->count = init_count;
+    sem->max_count = max_count;
+    return (pros::c::sem_t)sem;
+}
+
+pros::c::sem_t pros::c::sem_binary_create() {
+    return pros::c::sem_create(1, 0);
+}
+
+void pros::c::sem_delete(pros::c::sem_t sem) {
+    delete (SimSemaphore*)sem;
+}
+
+bool pros::c::sem_wait(pros::c::sem_t sem, std::uint32_t timeout) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimSemaphore* target = (SimSemaphore*)sem;
+
+    if (0 < target->count) {
+        target->count--;
+        return true;
+    }
+    if (0 == timeout) {
+        return false;
+    }
+
+    // post hands the count straight to the task it wakes and clears its
+    // target, a task that timed out still has it
+    self->semaphore_target = target;
+    block(self, WAIT_SEMAPHORE, timeout, guard);
+    bool taken = nullptr == self->semaphore_target;
+    self->semaphore_target = nullptr;
+
+    return taken;
+}
+
+bool pros::c::sem_post(pros::c::sem_t sem) {
+
+    std::unique_lock<std::mutex> guard(kernel->lock);
+    SimTask* self = kernel->current;
+    SimSemaphore* target = (SimSemaphore*)sem;
+    SimTask* next = nullptr;
+
+    for (SimTask* task : kernel->tasks) {
+        if (E_TASK_STATE_BLOCKED == task->state && WAIT_SEMAPHORE == task->waiting
+            && target == task->semaphore_target && (nullptr == next || task->priority > next->priority)) {
+            next = task;
+        }
+    }
+
+    if (nullptr != next) {
+        next->semaphore_target = nullptr;
+        make_ready(next);
+        preempt(self, guard);
+        return true;
+    }
+    if (target->count >= target->max_count) {
+        return false;
+    }
+
+    target->count++;
+    return true;
+}
+
+pros::Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth,
+    const char* name) {
+    this->task = pros::c::task_create(function, parameters, prio, stack_depth, name);
+}
+
+pros::Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+pros::Task::Task(task_t task) : task(task) {}
+
+pros::Task pros::Task::current() {
+    return Task(pros::c::task_get_current());
+}
+
+pros::Task& pros::Task::operator=(task_t in) {
+    this->task = in;
+    return *this;
+}
+
+void pros::Task::remove() {
+    pros::c::task_delete(this->task);
+}
+
+std::uint32_t pros::Task::get_priority() {
+    return pros::c::task_get_priority(this->task);
+}
+
+void pros::Task::set_priority(std::uint32_t prio) {
+    pros::c::task_set_priority(this->task, prio);
+}
+
+std::uint32_t pros::Task::get_state() {
+    return pros::c::task_get_state(this->task);
+}
+
+void pros::Task::suspend() {
+    pros::c::task_suspend(this->task);
+}
+
+void pros::Task::resume() {
+    pros::c::task_resume(this->task);
+}
+
+const char* pros::Task::get_name() {
+    return pros::c::task_get_name(this->task);
+}
+
+std::uint32_t pros::Task::notify() {
+    return pros::c::task_notify(this->task);
+}
+
+void pros::Task::join() {
+    pros::c::task_join(this->task);
+}
+
+std::uint32_t pros::Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return pros::c::task_notify_ext(this->task, value, action, prev_value);
+}
+
+std::uint32_t pros::Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return pros::c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool pros::Task::notify_clear() {
+    return pros::c::task_notify_clear(this->task);
+}
+
+void pros::Task::delay(const std::uint32_t milliseconds) {
+    pros::c::task_delay(milliseconds);
+}
+
+void pros::Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    pros::c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t pros::Task::get_count() {
+    return pros::c::task_get_count();
+}
+
+pros::Clock::time_point pros::Clock::now() {
+    return time_point{duration{pros::c::millis()}};
+}
+
+pros::Mutex::Mutex() : mutex(pros::c::mutex_create(), pros::c::mutex_delete) {}
+
+bool pros::Mutex::take() {
+    return pros::c::mutex_take(this->mutex.get(), TIMEOUT_MAX);
+}
+
+bool pros::Mutex::take(std::uint32_t timeout) {
+    return pros::c::mutex_take(this->mutex.get(), timeout);
+}
+
+bool pros::Mutex::give() {
+    return pros::c::mutex_give(this->mutex.get());
+}
+
+void pros::Mutex::lock() {
+    pros::c::mutex_take(this->mutex.get(), TIMEOUT_MAX);
+}
+
+void pros::Mutex::unlock() {
+    pros::c::mutex_give(this->mutex.get());
+}
+
+bool pros::Mutex::try_lock() {
+    return pros::c::mutex_take(this->mutex.get(), 0);
+}
@@ -0,0 +1,89 @@
+/**
+ * \file usd.cpp
+ *
+ * Contains the simulated SD card. fopen is interposed, so the file streams
+ * in the umbc sources open paths on "/usd/" in a temporary directory on the
+ * host instead.
+ */
+
+#include "sim.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <filesystem>
+#include <string>
+
+using namespace std;
+
+namespace {
+typedef FILE* (*fopen_fn)(const char*, const char*);
+
+constexpr char* usd_prefix = (char*)"/usd/";
+std::string usd_directory;
+
+/**
+ * Opens a file with the libc fopen the harness interposed.
+ */
+FILE* open_on_host(fopen_fn real, const char* path, const char* mode) {
+
+    std::string host = sim::host_path(path);
+
+    if (host != path && !sim::is_usd_installed()) {
+        errno = ENXIO;
+        return nullptr;
+    }
+    return real(host.c_str(), mode);
+}
+}
+
+extern "C" FILE* fopen(const char* path, const char* mode) {
+    static fopen_fn real = (fopen_fn)dlsym(RTLD_NEXT, "fopen");
+    return open_on_host(real, path, mode);
+}
+
+extern "C" FILE* fopen64(const char* path, const char* mode) {
+    static fopen_fn real = (fopen_fn)dlsym(RTLD_NEXT, "fopen64");
+    return open_on_host(real, path, mode);
+}
+
+std::int32_t sim::mount_usd() {
+
+    char directory[] = "/tmp/umbc_sim_XXXXXX";
+
+    if (nullptr == mkdtemp(directory)) {
+        std::perror("sim: could not create the SD card directory");
+        return 0;
+    }
+    usd_directory = directory;
+    return 1;
+}
+
+void sim::empty_usd() {
+
+    if (usd_directory.empty()) {
+        return;
+    }
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(usd_directory)) {
+        std::filesystem::remove_all(entry.path());
+    }
+}
+
+void sim::unmount_usd() {
+
+    if (!usd_directory.empty()) {
+        std::filesystem::remove_all(usd_directory);
+        usd_directory.clear();
+    }
+}
+
+std::string sim::host_path(const std::string& path) {
+
+    std::string prefix = usd_prefix;
+
+    if (usd_directory.empty() || 0 != path.compare(0, prefix.size(), prefix)) {
+        return path;
+    }
+    return usd_directory + "/" + path.substr(prefix.size());
+}
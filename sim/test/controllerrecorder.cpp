@@ -0,0 +1,107 @@
+/**
+ * \file controllerrecorder.cpp
+ *
+ * Contains the tests of the ControllerRecorder: recording a physical
+ * controller through the analog deadband.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+/**
+ * A stick that wobbles by up to 2 around 50, then is pushed to 60 and let
+ * go.
+ */
+ControllerInput wobbling_stick(std::uint32_t time_ms) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs] = {0, 0, 0, 0};
+
+    if (300 > time_ms) {
+        axes[1] = 50 + (time_ms / 10) % 3;
+    } else if (600 > time_ms) {
+        axes[1] = 60 - (time_ms / 10) % 2;
+    }
+    return ControllerInput(0, axes);
+}
+}
+
+SIM_TEST(recorder_holds_axes_within_the_deadband) {
+
+    PController controller(E_CONTROLLER_MASTER);
+    ControllerRecorder recorder(&controller, 10, E_CONTROLLER_MASTER, INPUT_ENCODING_RLE, 0, 2);
+    Recording recording;
+
+    sim::set_controller(E_CONTROLLER_MASTER, wobbling_stick);
+
+    recorder.start();
+    pros::Task::delay(1000);
+    recorder.stop();
+    SIM_EXPECT(100 == recorder.save("/usd/deadband.bin"));
+
+    // the wobble is held, but the push and the release are not
+    SIM_EXPECT(1 == recording.load("/usd/deadband.bin"));
+    SIM_EXPECT(3 == recording.get_number_of_events());
+    SIM_EXPECT(50 == recording.get_event(0).get_analog(E_CONTROLLER_ANALOG_LEFT_Y));
+    SIM_EXPECT(60 == recording.get_event(1).get_analog(E_CONTROLLER_ANALOG_LEFT_Y));
+    SIM_EXPECT(30 == recording.get_event_frame(1));
+    SIM_EXPECT(0 == recording.get_event(2).get_analog(E_CONTROLLER_ANALOG_LEFT_Y));
+    SIM_EXPECT(60 == recording.get_event_frame(2));
+}
+
+SIM_TEST(recorder_stops_its_tasks_when_destroyed) {
+
+    static std::uint32_t reads;
+    PController controller(E_CONTROLLER_MASTER);
+
+    reads = 0;
+    sim::set_controller(E_CONTROLLER_MASTER, [](std::uint32_t time_ms) {
+        reads++;
+        return wobbling_stick(time_ms);
+    });
+
+    {
+        ControllerRecorder recorder(&controller, 10);
+        ControllerRecorder streamer(&controller, 10);
+
+        recorder.start();
+        streamer.start("/usd/destroyed.bin");
+        pros::Task::delay(3000);
+    }
+
+    // nothing reads the controller once both recorders are gone
+    std::uint32_t reads_when_destroyed = reads;
+    SIM_EXPECT(0 < reads_when_destroyed);
+    pros::Task::delay(1000);
+    SIM_EXPECT(reads_when_destroyed == reads);
+}
+
+SIM_TEST(recorder_encodes_full_blocks_into_memory) {
+
+    PController controller(E_CONTROLLER_MASTER);
+    ControllerRecorder recorder(&controller, 10);
+    Recording recording;
+
+    sim::set_controller(E_CONTROLLER_MASTER, [](std::uint32_t time_ms) {
+        std::int8_t axes[ControllerInput::number_of_analogs] = {(std::int8_t)(time_ms / 100), 0, 0, 0};
+        return ControllerInput(0, axes);
+    });
+
+    // more than two blocks, and stopping keeps the partial block for later
+    recorder.start();
+    pros::Task::delay(4000);
+    recorder.stop();
+    recorder.start();
+    pros::Task::delay(2000);
+    recorder.stop();
+    SIM_EXPECT(600 == recorder.save("/usd/memory.bin"));
+    SIM_EXPECT(!recorder.hasControllerInput());
+
+    SIM_EXPECT(1 == recording.load("/usd/memory.bin"));
+    SIM_EXPECT(600 == recording.size());
+}
@@ -0,0 +1,55 @@
+/**
+ * \file edgedetector.cpp
+ *
+ * Contains the tests of the EdgeDetector: latching new presses until they
+ * are read.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+constexpr std::uint16_t mask(controller_digital_e_t button) {
+    return 1 << ControllerInput::digital_index(button);
+}
+}
+
+SIM_TEST(edge_detector_latches_new_presses) {
+
+    EdgeDetector edges;
+
+    edges.update(mask(E_CONTROLLER_DIGITAL_A));
+    edges.update(mask(E_CONTROLLER_DIGITAL_A) | mask(E_CONTROLLER_DIGITAL_B));
+    SIM_EXPECT((mask(E_CONTROLLER_DIGITAL_A) | mask(E_CONTROLLER_DIGITAL_B)) == edges.get());
+
+    // a press is reported once, even if the button is still held
+    SIM_EXPECT(edges.get_new_press(E_CONTROLLER_DIGITAL_A));
+    SIM_EXPECT(!edges.get_new_press(E_CONTROLLER_DIGITAL_A));
+    SIM_EXPECT(edges.get_new_press(E_CONTROLLER_DIGITAL_B));
+
+    // a press is kept after the button is let go until it is read
+    edges.update(mask(E_CONTROLLER_DIGITAL_X));
+    edges.update(0);
+    SIM_EXPECT(0 == edges.get());
+    SIM_EXPECT(mask(E_CONTROLLER_DIGITAL_X) == edges.get_new_presses());
+    SIM_EXPECT(0 == edges.get_new_presses());
+
+    // holding a button is not a new press, pressing it again is
+    edges.update(mask(E_CONTROLLER_DIGITAL_L1));
+    edges.update(mask(E_CONTROLLER_DIGITAL_L1));
+    SIM_EXPECT(edges.get_new_press(E_CONTROLLER_DIGITAL_L1));
+    edges.update(mask(E_CONTROLLER_DIGITAL_L1));
+    SIM_EXPECT(!edges.get_new_press(E_CONTROLLER_DIGITAL_L1));
+    edges.update(0);
+    edges.update(mask(E_CONTROLLER_DIGITAL_L1));
+    SIM_EXPECT(edges.get_new_press(E_CONTROLLER_DIGITAL_L1));
+
+    edges.update(mask(E_CONTROLLER_DIGITAL_UP));
+    edges.reset();
+    SIM_EXPECT(0 == edges.get() && 0 == edges.get_new_presses());
+}
@@ -0,0 +1,196 @@
+/**
+ * \file inputformat.cpp
+ *
+ * Contains the tests of the InputEncoder and InputDecoder: round trips of
+ * both encodings, rejecting corrupt files, and reading the files written
+ * before the current format.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+ControllerInput input(std::uint16_t buttons, std::int8_t a0, std::int8_t a1, std::int8_t a2, std::int8_t a3) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs] = {a0, a1, a2, a3};
+    return ControllerInput(buttons, axes);
+}
+
+/**
+ * Frames that hit every kind of record: long runs, small and large deltas,
+ * button changes, and late and early polls.
+ */
+void make_frames(std::vector<ControllerInput>& frames, std::vector<std::int16_t>& jitter) {
+
+    for (std::uint32_t i = 0; i < 300; i++) {
+        frames.push_back(input(0, 0, 0, 0, 0));
+        jitter.push_back(0);
+    }
+    for (std::int32_t i = 0; i < 40; i++) {
+        frames.push_back(input(1 << (i % 12), i * 3, -i * 3, i % 5, 127 - i));
+        jitter.push_back((0 == i % 7) ? i - 20 : 0);
+    }
+    for (std::uint32_t i = 0; i < 200; i++) {
+        frames.push_back(input(0x0FFF, -127, 127, -127, 127));
+        jitter.push_back((150 == i) ? 1000 : 0);
+    }
+}
+
+std::string encode(input_encoding encoding, const std::vector<ControllerInput>& frames,
+    const std::vector<std::int16_t>& jitter) {
+
+    std::stringstream out;
+    InputEncoder encoder(out, encoding);
+
+    encoder.write_header(10, E_CONTROLLER_PARTNER, INPUT_FLAG_TIMESTAMPS);
+    for (std::uint32_t i = 0; i < frames.size(); i++) {
+        encoder.push(frames[i], jitter[i]);
+    }
+    encoder.finish();
+
+    return out.str();
+}
+
+std::int32_t decodes_to(const std::string& encoded, const std::vector<ControllerInput>& frames,
+    const std::vector<std::int16_t>& jitter) {
+
+    InputDecoder decoder((const std::uint8_t*)encoded.data(), encoded.size());
+    ControllerInput controller_input;
+    std::int16_t jitter_ms;
+    std::uint16_t poll_rate_ms = 0;
+
+    if (INPUT_FORMAT_CRC != decoder.read_header(poll_rate_ms) || 10 != poll_rate_ms
+        || E_CONTROLLER_PARTNER != decoder.get_controller_id() || !decoder.has_timestamps()
+        || frames.size() != decoder.get_number_of_frames() || (std::int32_t)frames.size() != decoder.count()) {
+        return 0;
+    }
+
+    for (std::uint32_t i = 0; i < frames.size(); i++) {
+        if (1 != decoder.next(controller_input, jitter_ms) || frames[i] != controller_input
+            || jitter[i] != jitter_ms) {
+            return 0;
+        }
+    }
+
+    return 0 == decoder.next(controller_input, jitter_ms);
+}
+}
+
+SIM_TEST(input_format_round_trips_both_encodings) {
+
+    std::vector<ControllerInput> frames;
+    std::vector<std::int16_t> jitter;
+
+    make_frames(frames, jitter);
+
+    std::string rle = encode(INPUT_ENCODING_RLE, frames, jitter);
+    std::string packed = encode(INPUT_ENCODING_PACKED, frames, jitter);
+
+    SIM_EXPECT(decodes_to(rle, frames, jitter));
+    SIM_EXPECT(decodes_to(packed, frames, jitter));
+
+    // the runs of repeated frames cost a byte per 128 frames
+    SIM_EXPECT(rle.size() < packed.size() / 4);
+}
+
+SIM_TEST(input_format_rejects_a_bad_crc) {
+
+    std::vector<ControllerInput> frames;
+    std::vector<std::int16_t> jitter;
+    std::uint16_t poll_rate_ms = 0;
+
+    make_frames(frames, jitter);
+    std::string encoded = encode(INPUT_ENCODING_RLE, frames, jitter);
+
+    std::string body = encoded;
+    body[InputEncoder::header_size + 5] ^= 0x01;
+    InputDecoder body_decoder((const std::uint8_t*)body.data(), body.size());
+    SIM_EXPECT(0 == body_decoder.read_header(poll_rate_ms));
+
+    // peeking only reads the header, so the body is not checked
+    SIM_EXPECT(INPUT_FORMAT_CRC == body_decoder.peek_header(poll_rate_ms));
+    SIM_EXPECT(frames.size() == body_decoder.get_number_of_frames());
+
+    std::string header = encoded;
+    header[8] ^= 0x01;
+    InputDecoder header_decoder((const std::uint8_t*)header.data(), header.size());
+    SIM_EXPECT(0 == header_decoder.read_header(poll_rate_ms));
+
+    std::string truncated = encoded.substr(0, encoded.size() - 1);
+    InputDecoder truncated_decoder((const std::uint8_t*)truncated.data(), truncated.size());
+    SIM_EXPECT(0 == truncated_decoder.read_header(poll_rate_ms));
+}
+
+SIM_TEST(input_format_reads_legacy_files) {
+
+    // the poll rate, then each frame as the raw ControllerInput bitfields
+    const std::uint8_t data[] = {
+        20, 0,
+        0x01, 0x00, 10, 20, 30, 40,
+        0x00, 0x08, 0xF6, 0xEC, 0xE2, 0xD8,
+        0x00, 0x08, 0xF6, 0xEC, 0xE2, 0xD8
+    };
+    InputDecoder decoder(data, sizeof(data));
+    ControllerInput controller_input;
+    std::uint16_t poll_rate_ms = 0;
+
+    SIM_EXPECT(INPUT_FORMAT_LEGACY == decoder.read_header(poll_rate_ms));
+    SIM_EXPECT(20 == poll_rate_ms);
+    SIM_EXPECT(E_CONTROLLER_MASTER == decoder.get_controller_id());
+    SIM_EXPECT(3 == decoder.count());
+
+    SIM_EXPECT(1 == decoder.next(controller_input));
+    SIM_EXPECT(input(0x0001, 10, 20, 30, 40) == controller_input);
+    SIM_EXPECT(1 == decoder.next(controller_input));
+    SIM_EXPECT(input(0x0800, -10, -20, -30, -40) == controller_input);
+    SIM_EXPECT(1 == decoder.next(controller_input));
+    SIM_EXPECT(0 == decoder.next(controller_input));
+
+    // a partial frame at the end is an error, not the end of the file
+    InputDecoder truncated(data, sizeof(data) - 1);
+    SIM_EXPECT(INPUT_FORMAT_LEGACY == truncated.read_header(poll_rate_ms));
+    SIM_EXPECT(-1 == truncated.count());
+}
+
+SIM_TEST(input_format_reads_version_2_files) {
+
+    // the magic, version 2 and the poll rate, then a frame with buttons and
+    // a large delta, a run of three repeats and a frame with small deltas
+    const std::uint8_t data[] = {
+        0, 0, 'U', 'M', 'B', 'C', 2, 10, 0,
+        0x91, 0x05, 0x00, 100,
+        0x02,
+        0xC6, 0xE3
+    };
+    InputDecoder decoder(data, sizeof(data));
+    ControllerInput controller_input;
+    std::int16_t jitter_ms;
+    std::uint16_t poll_rate_ms = 0;
+
+    SIM_EXPECT(INPUT_FORMAT_RLE == decoder.read_header(poll_rate_ms));
+    SIM_EXPECT(10 == poll_rate_ms);
+    SIM_EXPECT(!decoder.has_timestamps());
+    SIM_EXPECT(5 == decoder.count());
+
+    for (std::uint32_t i = 0; i < 4; i++) {
+        SIM_EXPECT(1 == decoder.next(controller_input, jitter_ms));
+        SIM_EXPECT(input(0x0005, 100, 0, 0, 0) == controller_input);
+        SIM_EXPECT(0 == jitter_ms);
+    }
+    SIM_EXPECT(1 == decoder.next(controller_input));
+    SIM_EXPECT(input(0x0005, 100, 3, -2, 0) == controller_input);
+    SIM_EXPECT(0 == decoder.next(controller_input));
+
+    // a frame whose deltas are cut off
+    InputDecoder truncated(data, sizeof(data) - 1);
+    SIM_EXPECT(INPUT_FORMAT_RLE == truncated.read_header(poll_rate_ms));
+    SIM_EXPECT(-1 == truncated.count());
+}
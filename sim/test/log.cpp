@@ -0,0 +1,122 @@
+/**
+ * \file log.cpp
+ *
+ * Contains the tests of the Log. The drain task only runs while the test
+ * waits, so messages logged without waiting are still in the ring buffer.
+ * Every test logs from the main task, as LOG_MODULE_USER unless noted.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+/**
+ * Writes the ring buffer to a string instead of the terminal.
+ */
+std::string flush_log() {
+
+    std::ostringstream output;
+    std::streambuf* cout_buffer = std::cout.rdbuf(output.rdbuf());
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(output.rdbuf());
+
+    Log::flush();
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+    return output.str();
+}
+}
+
+SIM_TEST(log_formats_arguments_when_drained) {
+
+    std::string file_path = "/usd/match.bin";
+    char name[] = "vcontroller";
+
+    INFO("%s has %u frames at %dms, %.2f%% done", file_path, 4500u, -5, 12.5);
+    WARN("%s ran late %x times: %5s|%-4d|%c", name, 255, "ab", 7, 'z');
+    name[0] = 'X';
+    ERROR("no arguments, 100%% literal");
+    INFO("%s", std::string(200, 'a'));
+
+    std::string output = flush_log();
+    SIM_EXPECT(std::string::npos != output.find("\t/usd/match.bin has 4500 frames at -5ms, 12.50% done\n"));
+    SIM_EXPECT(std::string::npos != output.find("\tvcontroller ran late ff times:    ab|7   |z\n"));
+    SIM_EXPECT(std::string::npos != output.find("\tno arguments, 100% literal\n"));
+    SIM_EXPECT(std::string::npos != output.find(" [truncated]\n"));
+}
+
+SIM_TEST(log_records_time_level_module_and_task) {
+
+    pros::Task::delay(1500);
+    WARN("late by %ums", 3);
+
+#undef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_ROBOT
+    ERROR("could not open %s", "/usd/match.bin");
+#undef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_USER
+
+    std::string output = flush_log();
+    SIM_EXPECT(std::string::npos != output.find("1500\tWARN\tuser\tmain\tlate by 3ms\n"));
+    SIM_EXPECT(std::string::npos != output.find("1500\tERROR\trobot\tmain\tcould not open /usd/match.bin\n"));
+}
+
+SIM_TEST(log_compiles_out_disabled_levels) {
+
+    std::int32_t evaluated = 0;
+
+    static_assert(!log_is_enabled(LOG_MODULE_USER, LOG_LEVEL_DEBUG), "LOG_LEVEL defaults to LOG_LEVEL_INFO");
+    static_assert(log_is_enabled(LOG_MODULE_USER, LOG_LEVEL_INFO), "LOG_LEVEL defaults to LOG_LEVEL_INFO");
+    static_assert(!log_is_enabled(LOG_MODULE_USER, LOG_LEVEL_NONE), "LOG_LEVEL_NONE is never logged");
+
+    DEBUG("evaluated %d", ++evaluated);
+    INFO("evaluated %d", ++evaluated);
+
+    std::string output = flush_log();
+    SIM_EXPECT(1 == evaluated);
+    SIM_EXPECT(std::string::npos != output.find("\tINFO\tuser\tmain\tevaluated 1\n"));
+    SIM_EXPECT(std::string::npos == output.find("DEBUG"));
+}
+
+SIM_TEST(log_drops_messages_when_full) {
+
+    for (std::uint32_t i = 0; i < 200; i++) {
+        INFO("message %u", i);
+    }
+
+    std::string output = flush_log();
+    SIM_EXPECT(72 == Log::get_dropped());
+    SIM_EXPECT(0 == Log::get_dropped());
+    SIM_EXPECT(std::string::npos != output.find("\tmessage 127\n"));
+    SIM_EXPECT(std::string::npos == output.find("\tmessage 128\n"));
+
+    // the ring buffer is usable again once drained
+    INFO("message %u", 200);
+    SIM_EXPECT(std::string::npos != flush_log().find("\tmessage 200\n"));
+}
+
+SIM_TEST(log_drains_to_sd_card) {
+
+    Log::stop();
+    Log::start("/usd/log.txt");
+
+    INFO("written %u", 1);
+    ERROR("written %u", 2);
+    pros::Task::delay(100);
+    Log::stop();
+    Log::start();
+
+    std::ifstream file(sim::host_path("/usd/log.txt"));
+    std::stringstream contents;
+    contents << file.rdbuf();
+    SIM_EXPECT("0\tINFO\tuser\tmain\twritten 1\n0\tERROR\tuser\tmain\twritten 2\n" == contents.str());
+}
@@ -0,0 +1,55 @@
+/**
+ * \file looptiming.cpp
+ *
+ * Contains the tests of the LoopTiming, timed on the simulated clock.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+SIM_TEST(loop_timing_measures_lateness_and_body) {
+
+    LoopTiming loop_timing("test", 10);
+
+    // a 10 ms loop whose body takes 3 ms, and every tenth iteration 12 ms,
+    // waiting 9 ms after each body
+    for (std::uint32_t i = 0; i < 100; i++) {
+        loop_timing.begin();
+        pros::Task::delay((9 == i % 10) ? 12 : 3);
+        loop_timing.end();
+        pros::Task::delay(9);
+    }
+
+    SIM_EXPECT(100 == loop_timing.get_iterations());
+    SIM_EXPECT(10 == loop_timing.get_overruns());
+    SIM_EXPECT(12000 == loop_timing.get_max_duration_us());
+    SIM_EXPECT(11000 == loop_timing.get_max_lateness_us());
+    SIM_EXPECT(3000 <= loop_timing.get_duration_percentile_us(50));
+    SIM_EXPECT(3000 + 156 >= loop_timing.get_duration_percentile_us(50));
+    SIM_EXPECT(2000 <= loop_timing.get_lateness_percentile_us(50));
+    SIM_EXPECT(2000 + 156 >= loop_timing.get_lateness_percentile_us(50));
+    SIM_EXPECT(11000 == loop_timing.get_lateness_percentile_us(99));
+
+    loop_timing.reset();
+    SIM_EXPECT(0 == loop_timing.get_iterations());
+    SIM_EXPECT(0 == loop_timing.get_lateness_percentile_us(99));
+}
+
+SIM_TEST(opcontrol_loop_runs_at_its_period) {
+
+    Robot robot;
+
+    robot.opcontrol_start();
+    pros::Task::delay(1000);
+    robot.opcontrol_stop();
+
+    LoopTiming& loop_timing = robot.get_opcontrol_timing();
+    SIM_EXPECT(100 == loop_timing.get_iterations());
+    SIM_EXPECT(0 == loop_timing.get_overruns());
+    SIM_EXPECT(0 == loop_timing.get_max_lateness_us());
+}
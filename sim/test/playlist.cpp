@@ -0,0 +1,95 @@
+/**
+ * \file playlist.cpp
+ *
+ * Contains the tests of the Playlist: writing and parsing a playlist, and
+ * loading its clips as one Recording.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+void save_clip(const char* file_path, std::uint16_t poll_rate_ms, std::int8_t value, std::uint32_t number_of_frames) {
+
+    std::ofstream file(file_path, std::ofstream::binary);
+    InputEncoder encoder(file);
+    std::int8_t axes[ControllerInput::number_of_analogs] = {value, 0, 0, 0};
+
+    encoder.write_header(poll_rate_ms, E_CONTROLLER_MASTER);
+    for (std::uint32_t i = 0; i < number_of_frames; i++) {
+        encoder.push(ControllerInput(0, axes));
+    }
+    encoder.finish();
+}
+
+std::vector<std::uint8_t> read_file(const char* file_path) {
+
+    std::ifstream file(file_path, std::ifstream::binary);
+    return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+std::int32_t left_x(Recording& recording, std::uint32_t frame) {
+    return recording.get_frame(frame).get_analog(E_CONTROLLER_ANALOG_LEFT_X);
+}
+}
+
+SIM_TEST(playlist_round_trips) {
+
+    Playlist playlist;
+    Playlist parsed;
+
+    SIM_EXPECT(playlist.add("/usd/first.bin"));
+    SIM_EXPECT(playlist.add("/usd/second.bin", 250));
+    SIM_EXPECT(playlist.save("/usd/both.bin"));
+
+    std::vector<std::uint8_t> data = read_file("/usd/both.bin");
+    SIM_EXPECT(Playlist::is_playlist(data.data(), data.size()));
+    SIM_EXPECT(parsed.parse(data.data(), data.size()));
+    SIM_EXPECT(2 == parsed.size());
+    SIM_EXPECT("/usd/first.bin" == parsed.get_clip(0) && 0 == parsed.get_gap(0));
+    SIM_EXPECT("/usd/second.bin" == parsed.get_clip(1) && 250 == parsed.get_gap(1));
+
+    // a clip cut off part way through its path
+    SIM_EXPECT(!parsed.parse(data.data(), data.size() - 1));
+    SIM_EXPECT(0 == parsed.size());
+}
+
+SIM_TEST(playlist_plays_clips_in_order) {
+
+    Playlist playlist;
+    Recording recording;
+
+    save_clip("/usd/first.bin", 10, 40, 50);
+    save_clip("/usd/second.bin", 10, 80, 30);
+    playlist.add("/usd/first.bin");
+    playlist.add("/usd/second.bin", 95);
+    playlist.save("/usd/both.bin");
+
+    // the gap is rounded up to whole polls of neutral input
+    SIM_EXPECT(1 == recording.load("/usd/both.bin"));
+    SIM_EXPECT(10 == recording.get_poll_rate());
+    SIM_EXPECT(50 + 10 + 30 == recording.size());
+    SIM_EXPECT(900 == recording.get_duration());
+    SIM_EXPECT(40 == left_x(recording, 49));
+    SIM_EXPECT(0 == left_x(recording, 50) && 0 == left_x(recording, 59));
+    SIM_EXPECT(80 == left_x(recording, 60) && 80 == left_x(recording, 89));
+
+    // clips must share a poll rate
+    save_clip("/usd/second.bin", 20, 80, 30);
+    SIM_EXPECT(0 == recording.load("/usd/both.bin"));
+    SIM_EXPECT(0 == recording.size());
+
+    // a playlist that lists itself stops at the nesting limit
+    playlist.clear();
+    playlist.add("/usd/self.bin");
+    playlist.save("/usd/self.bin");
+    SIM_EXPECT(0 == recording.load("/usd/self.bin"));
+}
@@ -0,0 +1,61 @@
+/**
+ * \file posetrack.cpp
+ *
+ * Contains the tests of the PoseTrack: naming its file after a recording
+ * and saving and loading its poses.
+ */
+
+#include "sim.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+SIM_TEST(pose_track_is_named_after_its_recording) {
+
+    SIM_EXPECT("/usd/autonomous_match.pose" == PoseTrack::path_for("/usd/autonomous_match.bin"));
+    SIM_EXPECT("/usd/autonomous.match/run.pose" == PoseTrack::path_for("/usd/autonomous.match/run"));
+    SIM_EXPECT("run.pose" == PoseTrack::path_for("run"));
+}
+
+SIM_TEST(pose_track_round_trips) {
+
+    PoseTrack pose_track(10);
+    PoseTrack loaded;
+
+    // rounded to millimeters and hundredths of a degree, angles wrapped and
+    // positions saturated to what fits in 16 bits
+    pose_track.reserve(3);
+    pose_track.push({1.2344 * okapi::meter, -0.5 * okapi::meter, 45.004 * okapi::degree});
+    pose_track.push({40 * okapi::meter, -40 * okapi::meter, 370 * okapi::degree});
+    pose_track.push({0 * okapi::meter, 0 * okapi::meter, -190 * okapi::degree});
+    SIM_EXPECT(3 == pose_track.save("/usd/run.pose"));
+
+    SIM_EXPECT(1 == loaded.load("/usd/run.pose"));
+    SIM_EXPECT(10 == loaded.get_poll_rate());
+    SIM_EXPECT(3 == loaded.size());
+
+    okapi::OdomState first = loaded.get_pose(0);
+    SIM_EXPECT(1234 == std::lround(first.x.convert(okapi::millimeter)));
+    SIM_EXPECT(-500 == std::lround(first.y.convert(okapi::millimeter)));
+    SIM_EXPECT(4500 == std::lround(first.theta.convert(okapi::degree) * 100));
+
+    okapi::OdomState second = loaded.get_pose(1);
+    SIM_EXPECT(INT16_MAX == std::lround(second.x.convert(okapi::millimeter)));
+    SIM_EXPECT(INT16_MIN == std::lround(second.y.convert(okapi::millimeter)));
+    SIM_EXPECT(1000 == std::lround(second.theta.convert(okapi::degree) * 100));
+    SIM_EXPECT(17000 == std::lround(loaded.get_pose(2).theta.convert(okapi::degree) * 100));
+
+    // a file cut off part way through its poses
+    std::ifstream file(sim::host_path("/usd/run.pose"), std::ifstream::binary);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::ofstream(sim::host_path("/usd/cut.pose"), std::ofstream::binary) << data.substr(0, data.size() - 1);
+    SIM_EXPECT(0 == loaded.load("/usd/cut.pose"));
+    SIM_EXPECT(0 == loaded.size());
+    SIM_EXPECT(0 == loaded.load("/usd/missing.pose"));
+}
@@ -0,0 +1,71 @@
+/**
+ * \file recording.cpp
+ *
+ * Contains the tests of the Recording: refusing files whose body does not
+ * hold the frames their header promises.
+ */
+
+#include "sim.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+std::uint32_t crc32(std::uint32_t crc, const std::uint8_t* data, std::size_t size) {
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++) {
+        crc ^= data[i];
+        for (std::uint32_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+}
+
+SIM_TEST(recording_rejects_missing_frames) {
+
+    std::stringstream out;
+    InputEncoder encoder(out);
+    Recording recording;
+
+    encoder.write_header(10, E_CONTROLLER_MASTER);
+    for (std::int8_t i = 0; i < 10; i++) {
+        std::int8_t axes[ControllerInput::number_of_analogs] = {i, 0, 0, 0};
+        encoder.push(ControllerInput(0, axes));
+    }
+    encoder.finish();
+
+    // claim twice the frames, with a CRC that still matches
+    std::string data = out.str();
+    std::uint8_t* bytes = (std::uint8_t*)&(data[0]);
+    bytes[12] = 20;
+    std::uint32_t crc = crc32(crc32(0, &(bytes[InputEncoder::header_size]), data.size() - InputEncoder::header_size),
+        bytes, 16);
+    for (std::uint32_t i = 0; i < 4; i++) {
+        bytes[16 + i] = (crc >> (8 * i)) & 0xFF;
+    }
+    std::ofstream(sim::host_path("/usd/short.bin"), std::ofstream::binary) << data;
+
+    SIM_EXPECT(0 == recording.load("/usd/short.bin"));
+    SIM_EXPECT(0 == recording.size());
+    SIM_EXPECT(0 == recording.get_number_of_events());
+
+    bytes[12] = 10;
+    crc = crc32(crc32(0, &(bytes[InputEncoder::header_size]), data.size() - InputEncoder::header_size), bytes, 16);
+    for (std::uint32_t i = 0; i < 4; i++) {
+        bytes[16 + i] = (crc >> (8 * i)) & 0xFF;
+    }
+    std::ofstream(sim::host_path("/usd/short.bin"), std::ofstream::binary) << data;
+
+    SIM_EXPECT(1 == recording.load("/usd/short.bin"));
+    SIM_EXPECT(10 == recording.size());
+}
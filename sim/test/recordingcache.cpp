@@ -0,0 +1,79 @@
+/**
+ * \file recordingcache.cpp
+ *
+ * Contains the tests of the RecordingCache: preloading a controller input
+ * file together with the pose track saved next to it.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+void save_recording(const char* file_path) {
+
+    std::ofstream file(file_path, std::ofstream::binary);
+    InputEncoder encoder(file);
+    std::int8_t axes[ControllerInput::number_of_analogs] = {0, 127, 0, 0};
+
+    encoder.write_header(10, E_CONTROLLER_MASTER);
+    for (std::uint32_t i = 0; i < 100; i++) {
+        encoder.push(ControllerInput(0, axes));
+    }
+    encoder.finish();
+}
+}
+
+SIM_TEST(recording_cache_preloads_pose_tracks) {
+
+    RecordingCache cache;
+    PoseTrack pose_track(10);
+
+    save_recording("/usd/with_poses.bin");
+    save_recording("/usd/without_poses.bin");
+    for (std::uint32_t i = 0; i < 100; i++) {
+        pose_track.push({i * okapi::millimeter, 0 * okapi::millimeter, 0 * okapi::degree});
+    }
+    SIM_EXPECT(0 < pose_track.save(PoseTrack::path_for("/usd/with_poses.bin").c_str()));
+
+    cache.preload("/usd/with_poses.bin");
+    cache.preload("/usd/without_poses.bin");
+    pros::Task::delay(100);
+
+    // both are already in memory, nothing more is read from the SD card
+    sim::set_usd_installed(0);
+
+    std::shared_ptr<PoseTrack> cached = cache.get_pose_track("/usd/with_poses.bin");
+    SIM_EXPECT(nullptr != cached.get());
+    SIM_EXPECT(nullptr != cached.get() && 100 == cached->size());
+    SIM_EXPECT(nullptr != cache.get("/usd/with_poses.bin").get());
+    SIM_EXPECT(nullptr == cache.get_pose_track("/usd/without_poses.bin").get());
+    SIM_EXPECT(nullptr != cache.get("/usd/without_poses.bin").get());
+}
+
+SIM_TEST(recording_cache_waits_for_a_pending_file) {
+
+    std::uint32_t tasks = pros::Task::get_count();
+
+    save_recording("/usd/pending.bin");
+
+    {
+        RecordingCache cache;
+
+        // the preload task runs below this one, so get has to wait for it
+        cache.preload("/usd/pending.bin");
+        std::uint32_t start = pros::millis();
+        SIM_EXPECT(nullptr != cache.get("/usd/pending.bin").get());
+        SIM_EXPECT(10 > pros::millis() - start);
+        SIM_EXPECT(tasks + 1 == pros::Task::get_count());
+    }
+
+    // the preload task is stopped with the cache
+    SIM_EXPECT(tasks == pros::Task::get_count());
+}
@@ -0,0 +1,248 @@
+/**
+ * \file robot.cpp
+ *
+ * Contains the tests of the Robot: training autonomous and playing it back,
+ * and the selection menu.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+constexpr std::uint32_t segment_ms = 750;
+constexpr std::uint32_t segment_count = 40;
+
+/**
+ * A controller that holds a different input for every segment, then lets go.
+ */
+ControllerInput scripted_input(std::uint32_t time_ms, std::uint32_t seed) {
+
+    std::uint32_t segment = time_ms / segment_ms;
+    std::int8_t axes[ControllerInput::number_of_analogs] = {0};
+
+    if (segment_count <= segment) {
+        return ControllerInput();
+    }
+
+    // keep clear of the recorder's deadband
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        std::int32_t value = (std::int32_t)((segment * 37 + i * 53 + seed * 11) % 241) - 120;
+        axes[i] = (std::abs(value) <= 8) ? 64 : value;
+    }
+    return ControllerInput((1 << ((segment + seed) % ControllerInput::number_of_digitals)), axes);
+}
+
+/**
+ * Drops repeated samples, so input read every opcontrol loop can be
+ * compared regardless of when the loops ran.
+ */
+std::vector<ControllerInput> changes(const std::vector<sim::sample>& samples, std::int32_t partner) {
+
+    std::vector<ControllerInput> inputs;
+
+    for (const sim::sample& s : samples) {
+        const ControllerInput& input = partner ? s.partner : s.master;
+        if (inputs.empty() || inputs.back() != input) {
+            inputs.push_back(input);
+        }
+    }
+    return inputs;
+}
+
+/**
+ * Gets the time between the first and the last change of input.
+ */
+std::uint32_t active_ms(const std::vector<sim::sample>& samples) {
+
+    std::uint32_t first = 0;
+    std::uint32_t last = 0;
+
+    for (std::uint32_t i = 1; i < samples.size(); i++) {
+        if (samples[i].master != samples[i - 1].master) {
+            first = (0 == first) ? samples[i].time_ms : first;
+            last = samples[i].time_ms;
+        }
+    }
+    return last - first;
+}
+
+void train(Robot& robot) {
+
+    sim::set_controller(E_CONTROLLER_MASTER, [](std::uint32_t time_ms) { return scripted_input(time_ms, 0); });
+    sim::set_controller(E_CONTROLLER_PARTNER, [](std::uint32_t time_ms) { return scripted_input(time_ms, 5); });
+
+    robot.set_controllers_to_physical();
+    robot.train_autonomous(1);
+
+    sim::set_controller(E_CONTROLLER_MASTER, nullptr);
+    sim::set_controller(E_CONTROLLER_PARTNER, nullptr);
+}
+}
+
+SIM_TEST(train_then_autonomous_replays_inputs) {
+
+    Robot robot;
+
+    train(robot);
+    std::vector<sim::sample> trained = sim::trace();
+    sim::trace().clear();
+
+    Recording recording;
+    SIM_EXPECT(1 == recording.load("/usd/autonomous_match.bin"));
+    SIM_EXPECT(1 == recording.load("/usd/autonomous_match-partner.bin"));
+
+    robot.autonomous(1);
+    std::vector<sim::sample> played = sim::trace();
+
+    SIM_EXPECT(segment_count + 1 == changes(trained, 0).size());
+    SIM_EXPECT(changes(trained, 0) == changes(played, 0));
+    SIM_EXPECT(changes(trained, 1) == changes(played, 1));
+
+    // opcontrol sees a change at most a loop late in either run
+    std::uint32_t trained_ms = active_ms(trained);
+    std::uint32_t played_ms = active_ms(played);
+    SIM_EXPECT(trained_ms <= played_ms + 10 && played_ms <= trained_ms + 10);
+}
+
+SIM_TEST(autonomous_is_deterministic) {
+
+    Robot robot;
+    std::vector<sim::sample> runs[2];
+
+    train(robot);
+
+    for (std::uint32_t i = 0; i < 2; i++) {
+
+        sim::trace().clear();
+        robot.autonomous(1);
+
+        std::uint32_t start_ms = sim::trace().front().time_ms;
+        for (sim::sample s : sim::trace()) {
+            s.time_ms -= start_ms;
+            runs[i].push_back(s);
+        }
+    }
+
+    SIM_EXPECT(runs[0].size() == runs[1].size());
+    for (std::uint32_t i = 0; i < runs[0].size() && i < runs[1].size(); i++) {
+        SIM_EXPECT(runs[0][i].time_ms == runs[1][i].time_ms);
+        SIM_EXPECT(runs[0][i].master == runs[1][i].master);
+        SIM_EXPECT(runs[0][i].partner == runs[1][i].partner);
+    }
+}
+
+SIM_TEST(autonomous_keeps_its_length_under_every_policy) {
+
+    Robot robot;
+    playback_policy policies[] = {PLAYBACK_WALL_CLOCK, PLAYBACK_LOCKSTEP, PLAYBACK_CATCH_UP};
+
+    train(robot);
+
+    for (playback_policy policy : policies) {
+
+        robot.get_vcontroller_master()->set_policy(policy);
+        robot.get_vcontroller_partner()->set_policy(policy);
+
+        std::uint32_t start_ms = pros::millis();
+        robot.autonomous(1);
+        std::uint32_t duration_ms = pros::millis() - start_ms;
+
+        SIM_EXPECT(45000 <= duration_ms + 20 && 45000 + 20 >= duration_ms);
+    }
+}
+
+SIM_TEST(autonomous_without_sd_card_ends) {
+
+    Robot robot;
+
+    sim::set_usd_installed(0);
+    robot.autonomous(1);
+
+    SIM_EXPECT(changes(sim::trace(), 0).size() <= 1);
+}
+
+SIM_TEST(menu_selects_skills_training) {
+
+    Robot robot;
+
+    pros::lcd::initialize();
+
+    // right to skills and select, right to train autonomous and select
+    sim::set_lcd_buttons([](std::uint32_t time_ms) -> std::uint8_t {
+        if ((100 <= time_ms && 200 > time_ms) || (500 <= time_ms && 600 > time_ms)) {
+            return LCD_BTN_RIGHT;
+        }
+        return (300 <= time_ms && 400 > time_ms) || (700 <= time_ms && 800 > time_ms) ? LCD_BTN_CENTER : 0;
+    });
+    robot.menu();
+
+    SIM_EXPECT(COMPETITION_SKILLS == robot.get_competition());
+    SIM_EXPECT(MODE_TRAIN_AUTONOMOUS == robot.get_mode());
+    SIM_EXPECT("" == sim::get_lcd_line(1));
+
+    train(robot);
+
+    Recording recording;
+    SIM_EXPECT(1 == recording.load("/usd/autonomous_skills.bin"));
+    SIM_EXPECT(60000 <= recording.get_duration() + 10 && 60000 + 10 >= recording.get_duration());
+}
+
+SIM_TEST(menu_goes_back_to_previous_screen) {
+
+    Robot robot;
+
+    pros::lcd::initialize();
+    robot.set_routine_slot(3);
+
+    // match, left to back and select, then skills, competition and the
+    // only routine item, which goes back to train autonomous
+    sim::press_lcd_buttons({LCD_BTN_CENTER, LCD_BTN_LEFT, LCD_BTN_CENTER, LCD_BTN_RIGHT, LCD_BTN_CENTER,
+        LCD_BTN_CENTER, LCD_BTN_CENTER, LCD_BTN_RIGHT, LCD_BTN_CENTER});
+
+    // nothing is selected before the first press
+    pros::Task check([]() {
+        pros::Task::delay(50);
+        SIM_EXPECT("> Match" == sim::get_lcd_line(3));
+        SIM_EXPECT("  Skills" == sim::get_lcd_line(4));
+        pros::Task::delay(400);
+        SIM_EXPECT("> Back" == sim::get_lcd_line(5));
+        pros::Task::delay(800);
+        SIM_EXPECT("> No Routines Found" == sim::get_lcd_line(3));
+        pros::Task::delay(200);
+        SIM_EXPECT("  Train Autonomous" == sim::get_lcd_line(4));
+    });
+    robot.menu();
+
+    SIM_EXPECT(COMPETITION_SKILLS == robot.get_competition());
+    SIM_EXPECT(MODE_TRAIN_AUTONOMOUS == robot.get_mode());
+    SIM_EXPECT(0 == robot.get_routine_slot());
+    SIM_EXPECT(1800 <= pros::millis());
+}
+
+SIM_TEST(menu_outlives_a_deleted_menu_task) {
+
+    Robot robot;
+
+    pros::lcd::initialize();
+
+    // PROS deletes competition initialize while it waits in the menu
+    pros::Task waiting([&robot]() { robot.menu(); });
+    pros::Task::delay(50);
+    waiting.remove();
+
+    // pressed with no menu running, then skills and train autonomous
+    sim::press_lcd_buttons({LCD_BTN_RIGHT, LCD_BTN_RIGHT, LCD_BTN_CENTER, LCD_BTN_RIGHT, LCD_BTN_CENTER},
+        pros::millis() + 100);
+    pros::Task::delay(300);
+    robot.menu();
+
+    SIM_EXPECT(COMPETITION_SKILLS == robot.get_competition());
+    SIM_EXPECT(MODE_TRAIN_AUTONOMOUS == robot.get_mode());
+}
@@ -0,0 +1,116 @@
+/**
+ * \file routinecatalog.cpp
+ *
+ * Contains the tests of the RoutineCatalog: indexing routines from their
+ * headers, training into new slots, and picking a routine from the menu.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+/**
+ * Saves a controller input file that holds one input for a number of polls.
+ */
+void save_routine(const std::string& file_path, std::uint16_t poll_rate_ms, std::uint32_t number_of_frames) {
+
+    std::ofstream file(file_path, std::ofstream::binary);
+    InputEncoder encoder(file);
+    std::int8_t axes[ControllerInput::number_of_analogs] = {0, 127, 0, 0};
+
+    encoder.write_header(poll_rate_ms, E_CONTROLLER_MASTER);
+    for (std::uint32_t i = 0; i < number_of_frames; i++) {
+        encoder.push(ControllerInput(0, axes));
+    }
+    encoder.finish();
+}
+
+ControllerInput drive_forward(std::uint32_t time_ms) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs] = {0, (std::int8_t)(64 + time_ms / 1000), 0, 0};
+    return ControllerInput(0, axes);
+}
+}
+
+SIM_TEST(routine_catalog_indexes_headers) {
+
+    RoutineCatalog catalog;
+
+    save_routine("/usd/autonomous_match.bin", 10, 1500);
+    save_routine("/usd/autonomous_match-partner.bin", 10, 1500);
+    save_routine("/usd/autonomous_match_3.bin", 5, 9000);
+    save_routine("/usd/autonomous_skills_1.bin", 20, 10);
+    std::ofstream("/usd/autonomous_match_1.bin", std::ofstream::binary) << std::string("\0\0UMBX", 6);
+
+    SIM_EXPECT(3 == catalog.scan({"match", "skills"}));
+    SIM_EXPECT(catalog.is_scanned());
+
+    const Routine& first = catalog.get(0);
+    SIM_EXPECT("match" == first.tag && 0 == first.slot);
+    SIM_EXPECT("/usd/autonomous_match.bin" == first.file_path);
+    SIM_EXPECT(first.has_partner);
+    SIM_EXPECT(10 == first.poll_rate_ms && 15000 == first.duration_ms);
+    SIM_EXPECT("match 0  15.0s P" == RoutineCatalog::describe(first));
+
+    SIM_EXPECT(1 == catalog.find("match", 3));
+    SIM_EXPECT("match 3  45.0s" == RoutineCatalog::describe(catalog.get(1)));
+    SIM_EXPECT(2 == catalog.find("skills", 1));
+    SIM_EXPECT(-1 == catalog.find("match", 1));
+
+    // slot 1 holds a file that is not a routine and slot 0 of skills only a
+    // partner file, neither is overwritten
+    save_routine("/usd/autonomous_skills-partner.bin", 20, 10);
+    SIM_EXPECT(2 == catalog.next_slot("match"));
+    SIM_EXPECT(2 == catalog.next_slot("skills"));
+
+    save_routine("/usd/autonomous_match_2.bin", 10, 100);
+    SIM_EXPECT(catalog.update("match", 2));
+    SIM_EXPECT(1 == catalog.find("match", 2));
+    SIM_EXPECT(2 == catalog.find("match", 3));
+    SIM_EXPECT(3 == catalog.find("skills", 1));
+    SIM_EXPECT(4 == catalog.next_slot("match"));
+}
+
+SIM_TEST(training_saves_to_new_slots) {
+
+    Robot robot;
+
+    pros::lcd::initialize();
+    sim::set_controller(E_CONTROLLER_MASTER, drive_forward);
+    robot.set_controllers_to_physical();
+
+    robot.train_autonomous(0);
+    robot.train_autonomous(0);
+
+    Recording recording;
+    SIM_EXPECT(1 == recording.load("/usd/autonomous_match.bin"));
+    SIM_EXPECT(1 == recording.load("/usd/autonomous_match_1.bin"));
+    SIM_EXPECT(1 == robot.get_routine_slot());
+    SIM_EXPECT(2 == robot.get_routine_catalog().size());
+
+    // match, competition, then the first routine
+    sim::press_lcd_buttons({LCD_BTN_CENTER, LCD_BTN_CENTER, LCD_BTN_CENTER}, pros::millis() + 100);
+    pros::Task check([]() {
+        pros::Task::delay(350);
+        SIM_EXPECT(0 == sim::get_lcd_line(3).find("> match 0  "));
+        SIM_EXPECT(0 == sim::get_lcd_line(4).find("  match 1  "));
+        SIM_EXPECT("  Back" == sim::get_lcd_line(5));
+    });
+    robot.menu();
+
+    SIM_EXPECT(MODE_COMPETITION == robot.get_mode());
+    SIM_EXPECT(0 == robot.get_routine_slot());
+
+    // a new catalog finds both routines from their headers alone
+    RoutineCatalog catalog;
+    SIM_EXPECT(2 == catalog.scan({"match"}));
+    SIM_EXPECT(45000 <= catalog.get(1).duration_ms + 10 && 45000 + 10 >= catalog.get(1).duration_ms);
+}
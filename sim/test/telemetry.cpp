@@ -0,0 +1,147 @@
+/**
+ * \file telemetry.cpp
+ *
+ * Contains the tests of the Telemetry: the COBS framing, and a robot
+ * streamed to a file on the SD card and decoded as the host would.
+ */
+
+#include "sim.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+ControllerInput driver(std::uint32_t time_ms) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs] = {(std::int8_t)(time_ms / 100), 0, -127, 127};
+    return ControllerInput(0x801, axes);
+}
+
+/**
+ * Splits a stream into frames and decodes every valid packet.
+ */
+std::vector<TelemetryPacket> decode_stream(const std::vector<std::uint8_t>& stream, std::uint32_t* invalid) {
+
+    std::vector<TelemetryPacket> packets;
+    std::vector<std::uint8_t> frame;
+    std::uint8_t packet[Telemetry::max_frame_size];
+
+    *invalid = 0;
+    for (std::uint8_t byte : stream) {
+        if (0 != byte) {
+            frame.push_back(byte);
+            continue;
+        }
+
+        TelemetryPacket telemetry_packet;
+        std::int32_t size = (Telemetry::max_frame_size >= frame.size())
+            ? Telemetry::decode(frame.data(), frame.size(), packet) : -1;
+        if (0 <= size && Telemetry::parse(packet, size, &telemetry_packet)) {
+            packets.push_back(telemetry_packet);
+        } else {
+            (*invalid)++;
+        }
+        frame.clear();
+    }
+
+    return packets;
+}
+}
+
+SIM_TEST(telemetry_cobs_round_trips) {
+
+    std::vector<std::vector<std::uint8_t>> packets = {{}, {0}, {0, 0}, {1, 0, 2}, {0x11, 0x22, 0, 0x33}};
+    std::vector<std::uint8_t> long_packet(600, 0xAB);
+    long_packet[300] = 0;
+    packets.push_back(long_packet);
+    packets.push_back(std::vector<std::uint8_t>(254, 1));
+
+    for (const std::vector<std::uint8_t>& packet : packets) {
+        std::vector<std::uint8_t> frame(packet.size() + packet.size() / 254 + 2, 0xEE);
+        std::vector<std::uint8_t> decoded(frame.size());
+        std::uint32_t frame_size = Telemetry::encode(packet.data(), packet.size(), frame.data());
+
+        SIM_EXPECT(frame.size() >= frame_size);
+        SIM_EXPECT(0 == frame[frame_size - 1]);
+        for (std::uint32_t i = 0; i + 1 < frame_size; i++) {
+            SIM_EXPECT(0 != frame[i]);
+        }
+
+        std::int32_t size = Telemetry::decode(frame.data(), frame_size - 1, decoded.data());
+        SIM_EXPECT((std::int32_t)packet.size() == size);
+        SIM_EXPECT(std::equal(packet.begin(), packet.end(), decoded.begin()));
+    }
+
+    std::uint8_t invalid[] = {3, 1};
+    std::uint8_t decoded[8];
+    SIM_EXPECT(-1 == Telemetry::decode(invalid, sizeof(invalid), decoded));
+}
+
+SIM_TEST(telemetry_streams_robot_state) {
+
+    Robot robot;
+    Telemetry telemetry(&robot, TELEMETRY_CHANNEL_ALL, 10);
+
+    sim::set_controller(E_CONTROLLER_MASTER, driver);
+    sim::set_competition_status(COMPETITION_CONNECTED);
+    robot.set_controllers_to_physical();
+    robot.opcontrol_start();
+
+    FILE* file = std::fopen("/usd/telemetry.bin", "wb");
+    SIM_EXPECT(nullptr != file);
+    telemetry.start(file);
+    pros::Task::delay(1000);
+    telemetry.stop();
+    robot.opcontrol_stop();
+    std::fclose(file);
+
+    std::ifstream stream(sim::host_path("/usd/telemetry.bin"), std::ios::binary);
+    std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    std::uint32_t invalid = 0;
+    std::vector<TelemetryPacket> packets = decode_stream(bytes, &invalid);
+
+    SIM_EXPECT(0 == invalid);
+    SIM_EXPECT(100 == packets.size());
+    SIM_EXPECT(telemetry.get_packets() == packets.size());
+    SIM_EXPECT(0 == telemetry.get_failures());
+
+    for (std::uint32_t i = 0; i < packets.size(); i++) {
+        SIM_EXPECT(i == packets[i].sequence);
+        SIM_EXPECT(10 * i == packets[i].time_ms);
+    }
+
+    const TelemetryPacket& last = packets.back();
+    SIM_EXPECT(TELEMETRY_CHANNEL_ALL == last.channels);
+    SIM_EXPECT(driver(last.time_ms) == last.controller_master);
+    SIM_EXPECT(ControllerInput() == last.controller_partner);
+    SIM_EXPECT(MODE_COMPETITION == last.mode);
+    SIM_EXPECT(COMPETITION_CONNECTED == last.competition_status);
+    SIM_EXPECT(0 == last.playback_flags);
+    SIM_EXPECT(90 <= last.iterations);
+    SIM_EXPECT(0 == last.overruns);
+}
+
+SIM_TEST(telemetry_rejects_corrupt_packets) {
+
+    Robot robot;
+    Telemetry telemetry(&robot, TELEMETRY_CHANNEL_MODE | TELEMETRY_CHANNEL_PLAYBACK);
+    std::uint8_t packet[Telemetry::max_packet_size];
+    TelemetryPacket telemetry_packet;
+
+    std::uint32_t size = telemetry.pack(packet);
+    SIM_EXPECT(8 + 3 + 9 + 2 == size);
+    SIM_EXPECT(Telemetry::parse(packet, size, &telemetry_packet));
+    SIM_EXPECT(1 == telemetry_packet.playback_flags);
+
+    SIM_EXPECT(!Telemetry::parse(packet, size - 1, &telemetry_packet));
+    packet[9] ^= 0x40;
+    SIM_EXPECT(!Telemetry::parse(packet, size, &telemetry_packet));
+}
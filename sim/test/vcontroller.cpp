@@ -0,0 +1,177 @@
+/**
+ * \file vcontroller.cpp
+ *
+ * Contains the tests of the VController: resampling to its own poll rate,
+ * seeking, speed, looping and the playback policies.
+ */
+
+#include "sim.hpp"
+
+#include <cstdint>
+#include <fstream>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+namespace {
+constexpr std::uint32_t number_of_frames = 100;
+
+/**
+ * Saves one second of input polled every 10 ms, its left stick moving by 2
+ * every poll, so every frame can be told apart.
+ */
+void save_ramp(const char* file_path) {
+
+    std::ofstream file(file_path, std::ofstream::binary);
+    InputEncoder encoder(file);
+
+    encoder.write_header(10, E_CONTROLLER_MASTER);
+    for (std::uint32_t i = 0; i < number_of_frames; i++) {
+        std::int8_t axes[ControllerInput::number_of_analogs] = {(std::int8_t)(2 * i - 100), 0, 0, 0};
+        encoder.push(ControllerInput(0, axes));
+    }
+    encoder.finish();
+}
+
+std::int32_t left_x(VController& vcontroller) {
+    return vcontroller.get_analog(E_CONTROLLER_ANALOG_LEFT_X);
+}
+
+/**
+ * Plays a recording to its end.
+ *
+ * \return How long playback took.
+ */
+std::uint32_t play(VController& vcontroller) {
+
+    std::uint32_t start = pros::millis();
+
+    vcontroller.start();
+    vcontroller.wait_till_complete();
+
+    return pros::millis() - start;
+}
+}
+
+SIM_TEST(vcontroller_resamples_to_its_poll_rate) {
+
+    VController vcontroller(5);
+
+    save_ramp("/usd/ramp.bin");
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+
+    // polled at 5 ms, every other poll falls between two recorded frames
+    vcontroller.start();
+    pros::Task::delay(7);
+    SIM_EXPECT(-99 == left_x(vcontroller));
+    pros::Task::delay(5);
+    SIM_EXPECT(-98 == left_x(vcontroller));
+    pros::Task::delay(5);
+    SIM_EXPECT(-97 == left_x(vcontroller));
+
+    vcontroller.wait_till_complete();
+    SIM_EXPECT(!vcontroller.is_connected());
+    SIM_EXPECT(0 == left_x(vcontroller));
+}
+
+SIM_TEST(vcontroller_seeks_and_loops) {
+
+    VController vcontroller;
+
+    save_ramp("/usd/ramp.bin");
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+
+    // before playback a seek takes effect at once
+    vcontroller.seek(505);
+    SIM_EXPECT(505 == vcontroller.get_position());
+    SIM_EXPECT(0 == left_x(vcontroller));
+
+    vcontroller.set_loop(600, 700);
+    vcontroller.start();
+    pros::Task::delay(1000);
+    SIM_EXPECT(vcontroller.is_connected());
+    SIM_EXPECT(600 <= vcontroller.get_position() && 700 > vcontroller.get_position());
+    SIM_EXPECT(20 <= left_x(vcontroller) && 40 > left_x(vcontroller));
+
+    // during playback a seek takes effect on the next frame
+    vcontroller.set_loop(0, 0);
+    vcontroller.seek(900);
+    pros::Task::delay(15);
+    SIM_EXPECT(900 <= vcontroller.get_position() && 910 >= vcontroller.get_position());
+    SIM_EXPECT(80 <= left_x(vcontroller) && 82 >= left_x(vcontroller));
+
+    vcontroller.wait_till_complete();
+    SIM_EXPECT(!vcontroller.is_connected());
+}
+
+SIM_TEST(vcontroller_plays_at_speed) {
+
+    VController vcontroller;
+    VController resampled(10);
+
+    save_ramp("/usd/ramp.bin");
+
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+    vcontroller.set_speed(2);
+    std::uint32_t fast_ms = play(vcontroller);
+    SIM_EXPECT(500 <= fast_ms + 5 && 500 + 5 >= fast_ms);
+
+    SIM_EXPECT(resampled.load("/usd/ramp.bin"));
+    resampled.set_speed(0.5);
+    std::uint32_t slow_ms = play(resampled);
+    SIM_EXPECT(2000 <= slow_ms + 10 && 2000 + 10 >= slow_ms);
+
+    // an invalid speed is ignored
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+    vcontroller.set_speed(1);
+    vcontroller.set_speed(0);
+    std::uint32_t normal_ms = play(vcontroller);
+    SIM_EXPECT(1000 <= normal_ms + 10 && 1000 + 10 >= normal_ms);
+}
+
+SIM_TEST(vcontroller_follows_each_playback_policy) {
+
+    VController vcontroller;
+
+    save_ramp("/usd/ramp.bin");
+
+    // wall clock keeps the recorded timing with nobody reading
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+    vcontroller.set_policy(PLAYBACK_WALL_CLOCK);
+    std::uint32_t wall_clock_ms = play(vcontroller);
+    SIM_EXPECT(1000 <= wall_clock_ms + 10 && 1000 + 10 >= wall_clock_ms);
+
+    // lockstep takes exactly one frame per tick, however long it waits
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+    vcontroller.set_policy(PLAYBACK_LOCKSTEP);
+    vcontroller.start();
+    pros::Task::delay(500);
+    SIM_EXPECT(0 == vcontroller.get_position());
+    for (std::uint32_t i = 0; i < 50; i++) {
+        vcontroller.tick();
+        pros::Task::delay(30);
+    }
+    SIM_EXPECT(500 == vcontroller.get_position());
+    SIM_EXPECT(0 == left_x(vcontroller));
+    for (std::uint32_t i = 0; i < number_of_frames && vcontroller.is_connected(); i++) {
+        vcontroller.tick();
+        pros::Task::delay(30);
+    }
+    SIM_EXPECT(!vcontroller.is_connected());
+    vcontroller.wait_till_complete();
+
+    // catch up keeps the recorded timing, but never runs more than the
+    // max lead ahead of a slower reader
+    SIM_EXPECT(vcontroller.load("/usd/ramp.bin"));
+    vcontroller.set_policy(PLAYBACK_CATCH_UP, 1);
+    std::uint32_t start = pros::millis();
+    vcontroller.start();
+    for (std::uint32_t i = 0; i < 2 * number_of_frames && vcontroller.is_connected(); i++) {
+        pros::Task::delay(20);
+        SIM_EXPECT(vcontroller.get_position() <= (i + 2) * 10);
+        vcontroller.tick();
+    }
+    vcontroller.wait_till_complete();
+    SIM_EXPECT(1900 <= pros::millis() - start && 2100 >= pros::millis() - start);
+}
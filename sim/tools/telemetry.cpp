@@ -0,0 +1,118 @@
+/**
+ * \file telemetry.cpp
+ *
+ * Contains the host side decoder of the telemetry stream, see
+ * umbc/telemetry.hpp. Reads COBS frames from a file, a serial device or
+ * stdin and prints one CSV row per valid packet. Frames that fail to decode,
+ * e.g. text the robot printed on the same stream, are skipped and counted.
+ *
+ * Usage: umbc_telemetry [path]
+ *      path    the file or serial device to read, stdin if omitted
+ */
+
+#include "umbc.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace umbc;
+using namespace std;
+
+namespace {
+void print_header() {
+    std::printf("sequence,time_ms,master_buttons,master_axes,partner_buttons,partner_axes,competition,mode,"
+        "competition_status,playback_flags,position_master_ms,position_partner_ms,iterations,overruns,"
+        "max_lateness_us,max_duration_us\n");
+}
+
+void print_controller_input(const ControllerInput& controller_input) {
+    const std::int8_t* axes = controller_input.axes();
+    std::printf("0x%03x,%d %d %d %d,", controller_input.buttons(), axes[0], axes[1], axes[2], axes[3]);
+}
+
+void print_packet(const TelemetryPacket& packet) {
+
+    std::printf("%u,%u,", packet.sequence, packet.time_ms);
+
+    if (packet.channels & TELEMETRY_CHANNEL_CONTROLLER) {
+        print_controller_input(packet.controller_master);
+        print_controller_input(packet.controller_partner);
+    } else {
+        std::printf(",,,,");
+    }
+
+    if (packet.channels & TELEMETRY_CHANNEL_MODE) {
+        std::printf("%u,%u,0x%02x,", packet.competition, packet.mode, packet.competition_status);
+    } else {
+        std::printf(",,,");
+    }
+
+    if (packet.channels & TELEMETRY_CHANNEL_PLAYBACK) {
+        std::printf("%u,%u,%u,", packet.playback_flags, packet.position_master_ms, packet.position_partner_ms);
+    } else {
+        std::printf(",,,");
+    }
+
+    if (packet.channels & TELEMETRY_CHANNEL_LOOP_TIMING) {
+        std::printf("%u,%u,%u,%u\n", packet.iterations, packet.overruns, packet.max_lateness_us,
+            packet.max_duration_us);
+    } else {
+        std::printf(",,,\n");
+    }
+}
+}
+
+int main(int argc, char** argv) {
+
+    FILE* input = (1 < argc) ? std::fopen(argv[1], "rb") : stdin;
+    std::vector<std::uint8_t> frame;
+    std::vector<std::uint8_t> packet;
+    std::uint32_t valid = 0;
+    std::uint32_t invalid = 0;
+    std::uint32_t lost = 0;
+    std::int32_t last_sequence = -1;
+    std::int32_t c = 0;
+
+    if (nullptr == input) {
+        std::perror(argv[1]);
+        return 2;
+    }
+
+    print_header();
+
+    while (EOF != (c = std::fgetc(input))) {
+
+        if (0 != c) {
+            frame.push_back(c);
+            continue;
+        }
+
+        TelemetryPacket telemetry_packet;
+        packet.resize(frame.size());
+        std::int32_t size = Telemetry::decode(frame.data(), frame.size(), packet.data());
+        frame.clear();
+
+        if (0 > size || !Telemetry::parse(packet.data(), size, &telemetry_packet)) {
+            invalid++;
+            continue;
+        }
+
+        // sequence numbers wrap at 16 bits
+        if (0 <= last_sequence) {
+            lost += (std::uint16_t)(telemetry_packet.sequence - last_sequence - 1);
+        }
+        last_sequence = telemetry_packet.sequence;
+        valid++;
+
+        print_packet(telemetry_packet);
+        std::fflush(stdout);
+    }
+
+    std::fprintf(stderr, "%u packets, %u invalid frames, %u packets lost\n", valid, invalid, lost);
+    if (stdin != input) {
+        std::fclose(input);
+    }
+
+    return 0;
+}
@@ -27,9 +27,11 @@ umbc::Robot robot = Robot();
  */
 void initialize() {
 
+	umbc::Log::start();
 	INFO("initializing robot...");
 
 	pros::lcd::initialize();
+	robot.scan_routines();
 
 	INFO("robot initialized");
 }
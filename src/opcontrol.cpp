@@ -26,10 +26,16 @@ void umbc::Robot::opcontrol() {
 
     while(1) {
 
-        // implement opcontrols
+        // required loop start (do not edit)
+        this->opcontrol_begin();
 
+        // implement opcontrols, reading each controller once per loop, e.g.
+        //   ControllerInput input_master = controller_master->snapshot();
+        //   ControllerInput input_partner = controller_partner->snapshot();
 
-        // required loop delay (do not edit)
+
+        // required loop tick and delay (do not edit)
+        this->opcontrol_tick();
         pros::Task::delay(this->opcontrol_delay_ms);
     }
 }
\ No newline at end of file
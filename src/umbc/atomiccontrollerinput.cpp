@@ -0,0 +1,45 @@
+/**
+ * \file umbc/atomiccontrollerinput.cpp
+ *
+ * Contains the implementation of the AtomicControllerInput.
+ * AtomicControllerInput hands a whole ControllerInput from one task to
+ * others without a lock.
+ */
+
+#include "api.h"
+#include "umbc.h"
+
+#include <atomic>
+#include <cstdint>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::AtomicControllerInput::AtomicControllerInput() {
+    this->frame = 0;
+}
+
+void umbc::AtomicControllerInput::store(const ControllerInput& controller_input) {
+
+    std::uint64_t frame = controller_input.buttons();
+    const std::int8_t* axes = controller_input.axes();
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        frame |= (std::uint64_t)(std::uint8_t)axes[i] << (16 + 8 * i);
+    }
+
+    this->frame.store(frame, std::memory_order_release);
+}
+
+ControllerInput umbc::AtomicControllerInput::load() const {
+
+    std::uint64_t frame = this->frame.load(std::memory_order_acquire);
+    std::int8_t axes[ControllerInput::number_of_analogs];
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        axes[i] = (std::int8_t)(frame >> (16 + 8 * i));
+    }
+
+    return ControllerInput(frame & ControllerInput::digital_mask, axes);
+}
@@ -6,24 +6,61 @@
  * ControllerRecorder are meant to be used as input for the VController.
  */
 
+#define LOG_MODULE LOG_MODULE_RECORDER
+
 #include "api.h"
 #include "umbc.h"
 
 #include <fstream>
-#include <queue>
+#include <sstream>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
 using namespace pros;
 using namespace umbc;
 using namespace std;
 
-umbc::ControllerRecorder::ControllerRecorder(umbc::Controller* controller, std::uint16_t poll_rate_ms) {
+umbc::ControllerRecorder::ControllerRecorder(umbc::Controller* controller, std::uint16_t poll_rate_ms,
+    controller_id_e_t controller_id, input_encoding encoding, std::uint8_t flags, std::uint8_t analog_deadband) {
 
     this->controller = controller;
     this->poll_rate_ms = poll_rate_ms;
-    this->controller_input = std::queue<ControllerInput>();
+    this->controller_id = controller_id;
+    this->encoding = encoding;
+    this->flags = flags;
+    this->analog_deadband = analog_deadband;
+    this->previous_controller_input = ControllerInput();
+    this->max_jitter_ms = 0;
+    this->late_count = 0;
+    this->odometry = nullptr;
+    this->pose_capacity = 0;
+    this->pose_track = PoseTrack(poll_rate_ms);
     this->t_record_controller_input.reset(nullptr);
+
+    this->stream_file.reset(nullptr);
+    this->stream_encoder.reset(nullptr);
+    this->stream_blocks.reset(nullptr);
+    this->stream_jitter.reset(nullptr);
+    this->stream_block_full[0] = 0;
+    this->stream_block_full[1] = 0;
+    this->stream_block = 0;
+    this->stream_block_index = 0;
+    this->stream_count = 0;
+    this->stream_overruns = 0;
+    this->stream_dropped = 0;
+    this->stream_dropped_ms = 0;
+    this->stream_failed = 0;
+    this->stream_closing = 0;
+    this->stream_drained = pros::c::sem_binary_create();
+    this->t_flush_controller_input.reset(nullptr);
+}
+
+umbc::ControllerRecorder::~ControllerRecorder() {
+    this->stop();
+    this->stop_flush();
+    pros::c::sem_delete(this->stream_drained);
 }
 
 void umbc::ControllerRecorder::record(void* ControllerRecorder) {
@@ -36,48 +73,35 @@ void umbc::ControllerRecorder::record(void* ControllerRecorder) {
     }
 
     std::uint32_t now = pros::millis();
+    std::uint32_t previous_sample = now - controller_recorder->poll_rate_ms;
 
     INFO("recording controller input...");
-    while (INT32_MAX > controller_recorder->controller_input.size())
+    while (INT32_MAX > controller_recorder->stream_count)
     {
-        ControllerInput controller_input;
-
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_L1,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_L1));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_L2,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_L2));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_R1,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_R1));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_R2,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_R2));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_UP,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_UP));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_DOWN,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_DOWN));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_LEFT,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_LEFT));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_RIGHT,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_RIGHT));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_X,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_X));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_B,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_B));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_Y,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_Y));
-        controller_input.set_digital(E_CONTROLLER_DIGITAL_A,
-            controller_recorder->controller->get_digital(E_CONTROLLER_DIGITAL_A));
-
-        controller_input.set_analog(E_CONTROLLER_ANALOG_LEFT_X,
-            controller_recorder->controller->get_analog(E_CONTROLLER_ANALOG_LEFT_X));
-        controller_input.set_analog(E_CONTROLLER_ANALOG_LEFT_Y,
-            controller_recorder->controller->get_analog(E_CONTROLLER_ANALOG_LEFT_Y));
-        controller_input.set_analog(E_CONTROLLER_ANALOG_RIGHT_X,
-            controller_recorder->controller->get_analog(E_CONTROLLER_ANALOG_RIGHT_X));
-        controller_input.set_analog(E_CONTROLLER_ANALOG_RIGHT_Y,
-            controller_recorder->controller->get_analog(E_CONTROLLER_ANALOG_RIGHT_Y));
-
-        controller_recorder->controller_input.push(controller_input);
+        controller_recorder->loop_timing.begin();
+
+        std::uint32_t sample = pros::millis();
+        ControllerInput controller_input = controller_recorder->controller->snapshot();
+        controller_recorder->apply_deadband(controller_input);
+
+        std::int32_t jitter_ms = (std::int32_t)(sample - previous_sample) - controller_recorder->poll_rate_ms;
+        jitter_ms = (INT16_MAX < jitter_ms) ? INT16_MAX : jitter_ms;
+        previous_sample = sample;
+
+        if (controller_recorder->max_jitter_ms < jitter_ms) {
+            controller_recorder->max_jitter_ms = jitter_ms;
+        }
+        if (0 < jitter_ms) {
+            controller_recorder->late_count++;
+        }
 
+        if (nullptr != controller_recorder->odometry) {
+            controller_recorder->pose_track.push(controller_recorder->odometry->getState());
+        }
+
+        controller_recorder->stream(controller_input, jitter_ms);
+
+        controller_recorder->loop_timing.end();
         pros::Task::delay_until(&now, controller_recorder->poll_rate_ms);
     }
     INFO("max controller input recorded reached");
@@ -85,55 +109,319 @@ void umbc::ControllerRecorder::record(void* ControllerRecorder) {
     return;
 }
 
+void umbc::ControllerRecorder::flush(void* ControllerRecorder) {
+
+    umbc::ControllerRecorder* controller_recorder = (umbc::ControllerRecorder*)ControllerRecorder;
+    std::uint32_t block = 0;
+
+    while (1) {
+
+        pros::Task::notify_take(true, TIMEOUT_MAX);
+
+        while (controller_recorder->stream_block_full[block]) {
+
+            ControllerInput* controller_input = &(controller_recorder->stream_blocks[block * stream_block_size]);
+            std::int16_t* jitter_ms = &(controller_recorder->stream_jitter[block * stream_block_size]);
+
+            for (std::uint32_t i = 0; i < stream_block_size && !controller_recorder->stream_failed; i++) {
+                if (!controller_recorder->stream_encoder->push(controller_input[i], jitter_ms[i])) {
+                    controller_recorder->stream_failed = 1;
+                    if (controller_recorder->isStreaming()) {
+                        ERROR("failed to write controller input to %s", controller_recorder->stream_file_path);
+                    } else {
+                        ERROR("failed to encode controller input");
+                    }
+                }
+            }
+
+            controller_recorder->stream_block_full[block] = 0;
+            block = !block;
+        }
+
+        if (controller_recorder->stream_closing && !controller_recorder->stream_block_full[0]
+            && !controller_recorder->stream_block_full[1]) {
+            pros::c::sem_post(controller_recorder->stream_drained);
+        }
+    }
+}
+
+void umbc::ControllerRecorder::stream(ControllerInput& controller_input, std::int16_t jitter_ms) {
+
+    if (this->stream_block_full[this->stream_block]) {
+        this->stream_dropped++;
+        this->stream_dropped_ms += this->poll_rate_ms + jitter_ms;
+        return;
+    }
+
+    std::int32_t carried_ms = jitter_ms + this->stream_dropped_ms;
+    this->stream_dropped_ms = 0;
+
+    this->stream_blocks[this->stream_block * stream_block_size + this->stream_block_index] = controller_input;
+    this->stream_jitter[this->stream_block * stream_block_size + this->stream_block_index] =
+        (INT16_MAX < carried_ms) ? INT16_MAX : carried_ms;
+    this->stream_block_index++;
+    this->stream_count++;
+
+    if (stream_block_size > this->stream_block_index) {
+        return;
+    }
+
+    this->stream_block_full[this->stream_block] = 1;
+    this->t_flush_controller_input->notify();
+
+    this->stream_block = !this->stream_block;
+    this->stream_block_index = 0;
+
+    if (this->stream_block_full[this->stream_block]) {
+        this->stream_overruns++;
+        WARN("%s has fallen behind", t_flush_controller_input_name);
+    }
+}
+
+void umbc::ControllerRecorder::open_blocks() {
+
+    this->stop_flush();
+
+    if (nullptr == this->stream_blocks.get()) {
+        this->stream_blocks.reset(new ControllerInput[2 * stream_block_size]);
+        this->stream_jitter.reset(new std::int16_t[2 * stream_block_size]);
+    }
+
+    this->stream_block_full[0] = 0;
+    this->stream_block_full[1] = 0;
+    this->stream_block = 0;
+    this->stream_block_index = 0;
+    this->stream_count = 0;
+    this->stream_overruns = 0;
+    this->stream_dropped = 0;
+    this->stream_dropped_ms = 0;
+    this->stream_failed = 0;
+
+    this->t_flush_controller_input.reset(
+        new Task((task_fn_t)this->flush, (void*)this, TASK_PRIORITY_DEFAULT - 1,
+            TASK_STACK_DEPTH_DEFAULT, this->t_flush_controller_input_name));
+    DEBUG("%s has started", t_flush_controller_input_name);
+}
+
+std::int32_t umbc::ControllerRecorder::close_blocks() {
+
+    std::uint32_t start_ms = pros::millis();
+
+    // clear a signal left from closing before
+    while (pros::c::sem_wait(this->stream_drained, 0)) {}
+
+    this->stream_closing = 1;
+    while (this->stream_block_full[0] || this->stream_block_full[1]) {
+        std::uint32_t waited_ms = pros::millis() - start_ms;
+        if (close_timeout_ms <= waited_ms) {
+            this->stream_failed = 1;
+            ERROR("timed out waiting for %s", t_flush_controller_input_name);
+            break;
+        }
+        pros::c::sem_wait(this->stream_drained, close_timeout_ms - waited_ms);
+    }
+    this->stream_closing = 0;
+    this->stop_flush();
+
+    ControllerInput* controller_input = &(this->stream_blocks[this->stream_block * stream_block_size]);
+    std::int16_t* jitter_ms = &(this->stream_jitter[this->stream_block * stream_block_size]);
+    for (std::uint32_t i = 0; i < this->stream_block_index && !this->stream_failed; i++) {
+        this->stream_failed = !this->stream_encoder->push(controller_input[i], jitter_ms[i]);
+    }
+    this->stream_block_index = 0;
+
+    if (!this->stream_failed) {
+        this->stream_failed = !this->stream_encoder->finish();
+    }
+
+    if (0 < this->stream_overruns) {
+        WARN("%s fell behind %u times, %u controller inputs were dropped", t_flush_controller_input_name,
+            this->stream_overruns, this->stream_dropped);
+    }
+
+    return !this->stream_failed;
+}
+
+void umbc::ControllerRecorder::stop_flush() {
+
+    Task* t_flush = this->t_flush_controller_input.get();
+
+    if (nullptr != t_flush) {
+        try {
+            t_flush->remove();
+            DEBUG("%s is stopped", t_flush_controller_input_name);
+        } catch (...) {
+            ERROR("failed to stop %s", t_flush_controller_input_name);
+        }
+    }
+
+    // a deleted task is freed, it must not be stopped again
+    this->t_flush_controller_input.reset(nullptr);
+}
+
+std::int32_t umbc::ControllerRecorder::close_stream() {
+
+    std::int32_t number_of_controller_inputs = this->stream_count;
+
+    INFO("waiting for controller input to be written to %s...", this->stream_file_path);
+    std::int32_t closed = this->close_blocks();
+
+    this->stream_file->close();
+    if (!closed) {
+        number_of_controller_inputs = -1;
+        ERROR("failed to write controller input to %s", this->stream_file_path);
+    } else {
+        INFO("controller input written to %s", this->stream_file_path);
+    }
+    this->log_jitter();
+
+    if (0 < this->pose_track.size()) {
+        if (0 > this->pose_track.save(PoseTrack::path_for(this->stream_file_path).c_str())) {
+            number_of_controller_inputs = -1;
+        }
+        this->pose_track.clear();
+    }
+
+    this->stream_encoder.reset(nullptr);
+    this->stream_file.reset(nullptr);
+    this->stream_count = 0;
+
+    return number_of_controller_inputs;
+}
+
+std::int32_t umbc::ControllerRecorder::isStreaming() {
+    return nullptr != this->stream_file.get();
+}
+
+void umbc::ControllerRecorder::apply_deadband(ControllerInput& controller_input) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs];
+    const std::int8_t* previous_axes = this->previous_controller_input.axes();
+
+    std::memcpy(axes, controller_input.axes(), sizeof(axes));
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        if (0 != axes[i] && this->analog_deadband >= std::abs(axes[i] - previous_axes[i])) {
+            axes[i] = previous_axes[i];
+        }
+    }
+
+    controller_input.set_all(controller_input.buttons(), axes);
+    this->previous_controller_input = controller_input;
+}
+
+void umbc::ControllerRecorder::log_jitter() {
+
+    if (0 < this->late_count) {
+        WARN("%s ran late %u times, up to %dms", t_record_controller_input_name, this->late_count,
+            this->max_jitter_ms);
+    }
+    this->loop_timing.print();
+
+    this->max_jitter_ms = 0;
+    this->late_count = 0;
+}
+
 std::int32_t umbc::ControllerRecorder::save(const char* file_path) {
 
-    std::int32_t number_of_controller_inputs = this->controller_input.size();
+    std::int32_t number_of_controller_inputs = this->stream_count;
     
     string file_path_str = string(file_path);
 
-    if (0 == this->poll_rate_ms || this->controller_input.empty()) {
-        WARN("nothing to save to " + file_path_str);
+    if (this->isStreaming()) {
+        if (file_path_str != this->stream_file_path) {
+            WARN("controller input was streamed to %s, not %s", this->stream_file_path, file_path_str);
+        }
+        return this->close_stream();
+    }
+
+    if (0 == this->poll_rate_ms || nullptr == this->stream_encoder.get() || 0 == this->stream_count) {
+        WARN("nothing to save to %s", file_path_str);
+        return -1;
+    }
+
+    if (!this->close_blocks()) {
+        this->reset();
+        ERROR("failed to encode controller input for %s", file_path_str);
         return -1;
     }
 
     std::ofstream file(file_path, std::ifstream::binary);
     if (!file.good()) {
         file.close();
-        ERROR("could not open " + file_path_str);
+        ERROR("could not open %s", file_path_str);
         return -1;
     }
 
-    INFO("writing poll rate to " + file_path_str + "...");
-    file.write((char*)(&(this->poll_rate_ms)), sizeof(this->poll_rate_ms));
+    std::string encoded = this->controller_input.str();
+
+    INFO("writing controller input to %s...", file_path_str);
+    file.write(encoded.data(), encoded.size());
     if (!file.good()) {
         file.close();
-        ERROR("failed to write poll rate to " + file_path_str);
+        this->reset();
+        ERROR("failed to write controller input to %s", file_path_str);
         return -1;
     }
-    INFO("poll rate written to " + file_path_str);
+    INFO("%u bytes of controller input written to %s", encoded.size(), file_path_str);
+    file.close();
+    this->log_jitter();
 
-    INFO("writing controller input to " + file_path_str + "...");
-    while (!this->controller_input.empty()) {
-        file.write((char*)(&(this->controller_input.front())), sizeof(umbc::ControllerInput));
-        if (!file.good()) {
-            file.close();
-            this->reset();
-            ERROR("failed to write controller input to " + file_path_str);
-            return -1;
-        }
-        this->controller_input.pop();
+    if (0 < this->pose_track.size() && 0 > this->pose_track.save(PoseTrack::path_for(file_path_str).c_str())) {
+        number_of_controller_inputs = -1;
     }
-    INFO("controller input written to " + file_path_str);
-    file.close();
+    this->reset();
 
     return number_of_controller_inputs;
 }
 
 void umbc::ControllerRecorder::start() {
 
+    this->max_jitter_ms = 0;
+    this->late_count = 0;
+    this->loop_timing.reset(this->poll_rate_ms);
+    this->previous_controller_input = ControllerInput();
+
+    if (nullptr != this->odometry) {
+        this->pose_track.reserve(this->pose_capacity);
+    }
+
+    // a recording kept in memory goes through the same blocks as a stream,
+    // so the record task never grows the encoded buffer itself
+    if (nullptr == this->stream_encoder.get()) {
+        this->stream_encoder.reset(new InputEncoder(this->controller_input, this->encoding));
+        this->stream_encoder->write_header(this->poll_rate_ms, this->controller_id, this->flags);
+        this->open_blocks();
+    }
     this->t_record_controller_input.reset(
         new Task((task_fn_t)this->record, (void*)this, this->t_record_controller_input_name));
-    INFO(string(t_record_controller_input_name) + " has started");
+    DEBUG("%s has started", t_record_controller_input_name);
+}
+
+void umbc::ControllerRecorder::start(const char* file_path) {
+
+    string file_path_str = string(file_path);
+
+    this->stream_file.reset(new std::ofstream(file_path, std::ofstream::binary));
+    if (!this->stream_file->good()) {
+        this->stream_file.reset(nullptr);
+        ERROR("could not open %s", file_path_str);
+        return;
+    }
+
+    this->stream_encoder.reset(new InputEncoder(*(this->stream_file), this->encoding));
+    if (!this->stream_encoder->write_header(this->poll_rate_ms, this->controller_id, this->flags)) {
+        this->stream_encoder.reset(nullptr);
+        this->stream_file.reset(nullptr);
+        ERROR("failed to write poll rate to %s", file_path_str);
+        return;
+    }
+
+    this->stream_file_path = file_path_str;
+    this->pose_track.clear();
+    this->open_blocks();
+    INFO("streaming controller input to %s", file_path_str);
+
+    this->start();
 }
 
 void umbc::ControllerRecorder::pause() {
@@ -143,10 +431,10 @@ void umbc::ControllerRecorder::pause() {
     if (nullptr != t_record) {
         try {
             t_record->suspend();
-            INFO(string(t_record_controller_input_name) + " is paused");
+            DEBUG("%s is paused", t_record_controller_input_name);
         }
         catch (...) {
-            ERROR("failed to suspend " + string(t_record_controller_input_name));
+            ERROR("failed to suspend %s", t_record_controller_input_name);
         }
     }
 }
@@ -158,9 +446,9 @@ void umbc::ControllerRecorder::resume() {
     if (nullptr != t_record) {
         try {
             t_record->resume();
-            INFO(string(t_record_controller_input_name) + " has resumed");
+            DEBUG("%s has resumed", t_record_controller_input_name);
         } catch (...) {
-            ERROR("failed to resume " +  string(t_record_controller_input_name));
+            ERROR("failed to resume %s", t_record_controller_input_name);
         }
     }
 }
@@ -172,15 +460,33 @@ void umbc::ControllerRecorder::stop() {
     if (nullptr != t_record) {
         try {
             t_record->remove();
-            INFO(string(t_record_controller_input_name) + " is stopped");
+            DEBUG("%s is stopped", t_record_controller_input_name);
         } catch (...) {
-            ERROR("failed to stop " + string(t_record_controller_input_name));
+            ERROR("failed to stop %s", t_record_controller_input_name);
         }
     }
+
+    // a deleted task is freed, it must not be stopped again
+    this->t_record_controller_input.reset(nullptr);
+}
+
+void umbc::ControllerRecorder::set_odometry(okapi::Odometry* odometry, std::uint32_t max_duration_ms) {
+
+    this->odometry = odometry;
+    this->pose_capacity = (0 < this->poll_rate_ms) ? max_duration_ms / this->poll_rate_ms + 1 : 0;
 }
 
 void umbc::ControllerRecorder::reset() {
-    this->controller_input = queue<ControllerInput>();
+
+    if (!this->isStreaming()) {
+        this->stop_flush();
+        this->stream_encoder.reset(nullptr);
+        this->stream_block_index = 0;
+        this->stream_count = 0;
+    }
+    this->controller_input.str(std::string());
+    this->controller_input.clear();
+    this->pose_track.clear();
 }
 
 std::int32_t umbc::ControllerRecorder::isRecording() {
@@ -191,5 +497,9 @@ std::int32_t umbc::ControllerRecorder::isRecording() {
 }
 
 std::int32_t umbc::ControllerRecorder::hasControllerInput() {
-    return !this->controller_input.empty();
+    return 0 < this->stream_count;
+}
+
+LoopTiming& umbc::ControllerRecorder::get_loop_timing() {
+    return this->loop_timing;
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**
+ * \file umbc/edgedetector.cpp
+ *
+ * Contains the implementation of the EdgeDetector. The EdgeDetector latches
+ * rising edges (new presses) for all controller buttons at once from a
+ * button bitmask.
+ */
+
+#include "api.h"
+#include "umbc.h"
+
+#include <atomic>
+#include <cstdint>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::EdgeDetector::EdgeDetector() {
+    this->reset();
+}
+
+void umbc::EdgeDetector::update(std::uint16_t buttons) {
+
+    this->new_presses.fetch_or(buttons & ~this->current);
+    this->current = buttons;
+}
+
+void umbc::EdgeDetector::reset() {
+
+    this->current = 0;
+    this->new_presses = 0;
+}
+
+std::uint16_t umbc::EdgeDetector::get() {
+    return this->current;
+}
+
+std::int32_t umbc::EdgeDetector::get_new_press(controller_digital_e_t button) {
+
+    std::uint32_t index = ControllerInput::digital_index(button);
+    if (ControllerInput::number_of_digitals <= index) {
+        return 0;
+    }
+
+    std::uint16_t mask = 1 << index;
+    return 0 != (this->new_presses.fetch_and(~mask) & mask);
+}
+
+std::uint16_t umbc::EdgeDetector::get_new_presses() {
+    return this->new_presses.exchange(0);
+}
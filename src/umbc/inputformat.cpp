@@ -0,0 +1,519 @@
+/**
+ * \file umbc/inputformat.cpp
+ *
+ * Contains the implementation of the InputEncoder and InputDecoder. These
+ * classes read and write the binary controller input files created by the
+ * ControllerRecorder and played back by the VController.
+ */
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+static constexpr char file_magic[4] = {'U', 'M', 'B', 'C'};
+static constexpr std::size_t rle_header_size = 9;
+static constexpr std::size_t crc_offset = 16;
+
+static constexpr std::uint8_t tag_frame = 0x80;
+static constexpr std::uint8_t tag_small_deltas = 0x40;
+static constexpr std::uint8_t tag_jitter = 0x20;
+static constexpr std::uint8_t tag_digital = 0x10;
+
+static constexpr std::uint32_t crc32_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+/**
+ * Continues a CRC32 (IEEE 802.3) over more bytes. Start with a crc of 0.
+ */
+static std::uint32_t crc32(std::uint32_t crc, const std::uint8_t* data, std::size_t size) {
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; i++) {
+        crc = crc32_table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = crc32_table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+
+    return ~crc;
+}
+
+static void put_u16(std::uint8_t* data, std::uint16_t value) {
+    data[0] = value & 0xFF;
+    data[1] = value >> 8;
+}
+
+static void put_u32(std::uint8_t* data, std::uint32_t value) {
+    put_u16(data, value & 0xFFFF);
+    put_u16(&(data[2]), value >> 16);
+}
+
+static std::uint16_t get_u16(const std::uint8_t* data) {
+    return data[0] | (data[1] << 8);
+}
+
+static std::uint32_t get_u32(const std::uint8_t* data) {
+    return get_u16(data) | ((std::uint32_t)get_u16(&(data[2])) << 16);
+}
+
+/**
+ * Writes a signed value as a zigzag varint and returns the number of bytes
+ * written, at most 3 for a 16 bit value.
+ */
+static std::size_t put_varint(std::uint8_t* data, std::int16_t value) {
+
+    std::uint16_t zigzag = ((std::uint16_t)value << 1) ^ (std::uint16_t)(value >> 15);
+    std::size_t size = 0;
+
+    while (0x80 <= zigzag) {
+        data[size++] = (zigzag & 0x7F) | 0x80;
+        zigzag >>= 7;
+    }
+    data[size++] = zigzag;
+
+    return size;
+}
+
+/**
+ * Reads a zigzag varint written by put_varint and returns the number of bytes
+ * read, or 0 if the varint is truncated or too long.
+ */
+static std::size_t get_varint(const std::uint8_t* data, std::size_t size, std::int16_t& value) {
+
+    std::uint32_t zigzag = 0;
+
+    for (std::size_t i = 0; i < size && i < 3; i++) {
+        zigzag |= (std::uint32_t)(data[i] & 0x7F) << (7 * i);
+        if (!(data[i] & 0x80)) {
+            value = (std::int16_t)((zigzag >> 1) ^ -(zigzag & 1));
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+static void pack_frame(const ControllerInput& controller_input, std::uint8_t* data) {
+
+    put_u16(data, controller_input.buttons());
+    std::memcpy(&(data[2]), controller_input.axes(), ControllerInput::number_of_analogs);
+}
+
+static void unpack_frame(const std::uint8_t* data, ControllerInput& controller_input) {
+    controller_input.set_all(get_u16(data), (const std::int8_t*)&(data[2]));
+}
+
+umbc::InputEncoder::InputEncoder(std::ostream& out, input_encoding encoding) : out(out) {
+
+    this->encoding = encoding;
+    this->flags = 0;
+    this->header_position = 0;
+    std::memset(this->header, 0, sizeof(this->header));
+    this->previous = ControllerInput();
+    this->run_length = 0;
+    this->number_of_frames = 0;
+    this->crc = 0;
+}
+
+std::int32_t umbc::InputEncoder::write(const std::uint8_t* data, std::size_t size) {
+
+    this->crc = crc32(this->crc, data, size);
+    this->out.write((const char*)data, size);
+
+    return this->out.good();
+}
+
+std::int32_t umbc::InputEncoder::write_run() {
+
+    while (0 < this->run_length) {
+        std::uint8_t length = this->run_length < max_run_length ? this->run_length : max_run_length;
+        std::uint8_t tag = length - 1;
+        if (!this->write(&tag, sizeof(tag))) {
+            return 0;
+        }
+        this->run_length -= length;
+    }
+
+    return this->out.good();
+}
+
+std::int32_t umbc::InputEncoder::write_header(std::uint16_t poll_rate_ms, controller_id_e_t controller_id, std::uint8_t flags) {
+
+    std::memset(this->header, 0, sizeof(this->header));
+    std::memcpy(&(this->header[2]), file_magic, sizeof(file_magic));
+    this->header[6] = INPUT_FORMAT_CRC;
+    this->header[7] = this->encoding;
+    put_u16(&(this->header[8]), poll_rate_ms);
+    this->header[10] = controller_id;
+    this->header[11] = flags;
+
+    this->flags = flags;
+    this->previous = ControllerInput();
+    this->run_length = 0;
+    this->number_of_frames = 0;
+    this->crc = 0;
+
+    this->header_position = this->out.tellp();
+    this->out.write((const char*)this->header, sizeof(this->header));
+
+    return this->out.good();
+}
+
+std::int32_t umbc::InputEncoder::push(const ControllerInput& controller_input, std::int16_t jitter_ms) {
+
+    this->number_of_frames++;
+
+    if (!(this->flags & INPUT_FLAG_TIMESTAMPS)) {
+        jitter_ms = 0;
+    }
+
+    if (INPUT_ENCODING_PACKED == this->encoding) {
+        std::uint8_t frame[packed_frame_size + sizeof(std::int16_t)];
+        pack_frame(controller_input, frame);
+        put_u16(&(frame[packed_frame_size]), jitter_ms);
+        return this->write(frame, (this->flags & INPUT_FLAG_TIMESTAMPS) ? sizeof(frame) : packed_frame_size);
+    }
+
+    std::uint8_t record[1 + sizeof(std::uint16_t) + ControllerInput::number_of_analogs + 3];
+    std::uint8_t record_size = 1;
+    std::uint8_t deltas[ControllerInput::number_of_analogs];
+    std::uint8_t number_of_deltas = 0;
+    std::uint8_t tag = tag_frame | tag_small_deltas;
+
+    if (controller_input == this->previous && 0 == jitter_ms) {
+        this->run_length++;
+        return (max_run_length > this->run_length) ? 1 : this->write_run();
+    }
+
+    if (!this->write_run()) {
+        return 0;
+    }
+
+    if (controller_input.buttons() != this->previous.buttons()) {
+        tag |= tag_digital;
+        put_u16(&(record[record_size]), controller_input.buttons());
+        record_size += sizeof(std::uint16_t);
+    }
+
+    const std::int8_t* axes = controller_input.axes();
+    const std::int8_t* previous_axes = this->previous.axes();
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        std::int8_t delta = (std::int8_t)(axes[i] - previous_axes[i]);
+
+        if (0 != delta) {
+            tag |= 1 << i;
+            deltas[number_of_deltas++] = (std::uint8_t)delta;
+            if (-8 > delta || 7 < delta) {
+                tag &= ~tag_small_deltas;
+            }
+        }
+    }
+
+    if (tag & tag_small_deltas) {
+        for (std::uint32_t i = 0; i < number_of_deltas; i += 2) {
+            std::uint8_t high = (i + 1 < number_of_deltas) ? deltas[i + 1] : 0;
+            record[record_size++] = (deltas[i] & 0x0F) | (high << 4);
+        }
+    } else {
+        std::memcpy(&(record[record_size]), deltas, number_of_deltas);
+        record_size += number_of_deltas;
+    }
+
+    if (0 != jitter_ms) {
+        tag |= tag_jitter;
+        record_size += put_varint(&(record[record_size]), jitter_ms);
+    }
+    record[0] = tag;
+
+    this->previous = controller_input;
+    return this->write(record, record_size);
+}
+
+std::int32_t umbc::InputEncoder::finish() {
+
+    if (!this->write_run()) {
+        return 0;
+    }
+
+    put_u32(&(this->header[12]), this->number_of_frames);
+    put_u32(&(this->header[crc_offset]), crc32(this->crc, this->header, crc_offset));
+
+    std::streampos end_position = this->out.tellp();
+    this->out.seekp(this->header_position);
+    this->out.write((const char*)this->header, sizeof(this->header));
+    this->out.seekp(end_position);
+
+    return this->out.good();
+}
+
+umbc::InputDecoder::InputDecoder(const std::uint8_t* data, std::size_t size) {
+
+    this->data = data;
+    this->size = size;
+    this->offset = 0;
+    this->version = 0;
+    this->encoding = INPUT_ENCODING_RLE;
+    this->controller_id = E_CONTROLLER_MASTER;
+    this->flags = 0;
+    this->number_of_frames = 0;
+    this->number_of_frames_decoded = 0;
+    this->previous = ControllerInput();
+    this->run_remaining = 0;
+}
+
+std::int32_t umbc::InputDecoder::parse_header(std::uint16_t& poll_rate_ms, std::int32_t check_crc) {
+
+    this->offset = 0;
+    this->version = 0;
+    this->encoding = INPUT_ENCODING_RLE;
+    this->controller_id = E_CONTROLLER_MASTER;
+    this->flags = 0;
+    this->number_of_frames = 0;
+    this->number_of_frames_decoded = 0;
+    this->run_remaining = 0;
+    this->previous = ControllerInput();
+
+    if (sizeof(std::uint16_t) > this->size) {
+        return 0;
+    }
+
+    std::uint16_t legacy_poll_rate_ms = get_u16(this->data);
+    if (0 != legacy_poll_rate_ms) {
+        poll_rate_ms = legacy_poll_rate_ms;
+        this->offset = sizeof(std::uint16_t);
+        this->version = INPUT_FORMAT_LEGACY;
+        return this->version;
+    }
+
+    if (rle_header_size > this->size || 0 != std::memcmp(&(this->data[2]), file_magic, sizeof(file_magic))) {
+        return 0;
+    }
+
+    std::int32_t version = this->data[6];
+
+    if (INPUT_FORMAT_RLE == version) {
+        poll_rate_ms = get_u16(&(this->data[7]));
+        this->offset = rle_header_size;
+    } else if (INPUT_FORMAT_CRC == version) {
+        if (InputEncoder::header_size > this->size) {
+            return 0;
+        }
+
+        if (check_crc) {
+            std::uint32_t crc = crc32(0, &(this->data[InputEncoder::header_size]),
+                this->size - InputEncoder::header_size);
+            if (get_u32(&(this->data[crc_offset])) != crc32(crc, this->data, crc_offset)) {
+                return 0;
+            }
+        }
+
+        this->encoding = (input_encoding)this->data[7];
+        if (INPUT_ENCODING_PACKED != this->encoding && INPUT_ENCODING_RLE != this->encoding) {
+            return 0;
+        }
+
+        poll_rate_ms = get_u16(&(this->data[8]));
+        this->controller_id = this->data[10];
+        this->flags = this->data[11];
+        if (this->flags & ~INPUT_FLAG_TIMESTAMPS) {
+            return 0;
+        }
+
+        this->number_of_frames = get_u32(&(this->data[12]));
+        this->offset = InputEncoder::header_size;
+    } else {
+        return 0;
+    }
+
+    if (0 == poll_rate_ms) {
+        return 0;
+    }
+
+    this->version = version;
+    return this->version;
+}
+
+std::int32_t umbc::InputDecoder::read_header(std::uint16_t& poll_rate_ms) {
+    return this->parse_header(poll_rate_ms, 1);
+}
+
+std::int32_t umbc::InputDecoder::peek_header(std::uint16_t& poll_rate_ms) {
+    return this->parse_header(poll_rate_ms, 0);
+}
+
+std::uint32_t umbc::InputDecoder::get_number_of_frames() {
+    return this->number_of_frames;
+}
+
+controller_id_e_t umbc::InputDecoder::get_controller_id() {
+    return (controller_id_e_t)this->controller_id;
+}
+
+std::int32_t umbc::InputDecoder::has_timestamps() {
+    return 0 != (this->flags & INPUT_FLAG_TIMESTAMPS);
+}
+
+std::int32_t umbc::InputDecoder::next_rle(ControllerInput& controller_input, std::int16_t& jitter_ms) {
+
+    jitter_ms = 0;
+
+    if (0 < this->run_remaining) {
+        this->run_remaining--;
+        controller_input = this->previous;
+        return 1;
+    }
+
+    if (this->offset == this->size) {
+        return 0;
+    }
+
+    std::uint8_t tag = this->data[this->offset++];
+
+    if (!(tag & tag_frame)) {
+        this->run_remaining = tag;
+        controller_input = this->previous;
+        return 1;
+    }
+
+    std::uint16_t buttons = this->previous.buttons();
+    std::int8_t axes[ControllerInput::number_of_analogs];
+    std::memcpy(axes, this->previous.axes(), sizeof(axes));
+
+    if (tag & tag_digital) {
+        if (sizeof(std::uint16_t) > this->size - this->offset) {
+            return -1;
+        }
+        buttons = get_u16(&(this->data[this->offset]));
+        this->offset += sizeof(std::uint16_t);
+    }
+
+    std::uint8_t packed = 0;
+    std::uint32_t number_of_deltas = 0;
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+
+        if (!(tag & (1 << i))) {
+            continue;
+        }
+
+        std::int8_t delta;
+        if (tag & tag_small_deltas) {
+            if (0 == number_of_deltas % 2) {
+                if (this->offset == this->size) {
+                    return -1;
+                }
+                packed = this->data[this->offset++];
+            }
+            std::uint8_t nibble = (number_of_deltas % 2) ? (packed >> 4) : (packed & 0x0F);
+            delta = (nibble & 0x08) ? (std::int8_t)(nibble | 0xF0) : (std::int8_t)nibble;
+        } else {
+            if (this->offset == this->size) {
+                return -1;
+            }
+            delta = (std::int8_t)this->data[this->offset++];
+        }
+        number_of_deltas++;
+
+        axes[i] += delta;
+    }
+
+    if (tag & tag_jitter) {
+        std::size_t varint_size = get_varint(&(this->data[this->offset]), this->size - this->offset, jitter_ms);
+        if (0 == varint_size) {
+            return -1;
+        }
+        this->offset += varint_size;
+    }
+
+    this->previous.set_all(buttons, axes);
+    controller_input = this->previous;
+    return 1;
+}
+
+std::int32_t umbc::InputDecoder::next(ControllerInput& controller_input) {
+
+    std::int16_t jitter_ms;
+    return this->next(controller_input, jitter_ms);
+}
+
+std::int32_t umbc::InputDecoder::next(ControllerInput& controller_input, std::int16_t& jitter_ms) {
+
+    std::int32_t status;
+    std::size_t frame_size = InputEncoder::packed_frame_size;
+
+    jitter_ms = 0;
+
+    switch (this->version) {
+        case INPUT_FORMAT_LEGACY:
+            // legacy files hold the raw ControllerInput bitfields written by
+            // GCC on the V5, which have the same layout as a packed frame
+            if (this->offset == this->size) {
+                return 0;
+            } else if (InputEncoder::packed_frame_size > this->size - this->offset) {
+                return -1;
+            }
+            unpack_frame(&(this->data[this->offset]), controller_input);
+            this->offset += InputEncoder::packed_frame_size;
+            return 1;
+        case INPUT_FORMAT_RLE:
+            return this->next_rle(controller_input, jitter_ms);
+        case INPUT_FORMAT_CRC:
+            if (this->number_of_frames == this->number_of_frames_decoded) {
+                return 0;
+            }
+
+            if (INPUT_ENCODING_PACKED == this->encoding) {
+                if (this->has_timestamps()) {
+                    frame_size += sizeof(std::int16_t);
+                }
+                if (frame_size > this->size - this->offset) {
+                    return -1;
+                }
+                unpack_frame(&(this->data[this->offset]), controller_input);
+                if (this->has_timestamps()) {
+                    jitter_ms = (std::int16_t)get_u16(&(this->data[this->offset + InputEncoder::packed_frame_size]));
+                }
+                this->offset += frame_size;
+                status = 1;
+            } else {
+                status = this->next_rle(controller_input, jitter_ms);
+            }
+
+            if (1 == status) {
+                this->number_of_frames_decoded++;
+                return 1;
+            }
+            return -1;
+        default:
+            return -1;
+    }
+}
+
+std::int32_t umbc::InputDecoder::count() {
+
+    if (INPUT_FORMAT_CRC == this->version) {
+        return this->number_of_frames - this->number_of_frames_decoded;
+    }
+
+    InputDecoder decoder = *this;
+    ControllerInput controller_input;
+    std::int32_t number_of_controller_inputs = 0;
+    std::int32_t status;
+
+    while (1 == (status = decoder.next(controller_input))) {
+        number_of_controller_inputs++;
+    }
+
+    return (0 == status) ? number_of_controller_inputs : -1;
+}
@@ -0,0 +1,401 @@
+/**
+ * \file umbc/log.cpp
+ *
+ * Contains the implementation of the Log. Messages are queued in a bounded
+ * ring buffer by the logging task and formatted by a low priority drain
+ * task, so logging never blocks on the terminal or the SD card.
+ */
+
+#define LOG_MODULE LOG_MODULE_LOG
+
+#include "api.h"
+#include "umbc.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+static constexpr const char* level_names[] = {"DEBUG", "INFO", "WARN", "ERROR", "NONE"};
+static constexpr const char* module_names[LOG_MODULE_COUNT] = {"user", "robot", "recorder", "playback",
+    "recording", "pose", "timing", "log", "telemetry"};
+
+/**
+ * The sequence of an entry is stored relative to its index, so the zero
+ * initialized ring buffer starts with every entry free for its own position
+ * and needs no constructor to run before the first message is logged.
+ */
+umbc::Log::Entry umbc::Log::entries[umbc::Log::number_of_entries];
+std::atomic<std::uint32_t> umbc::Log::enqueue_position;
+std::atomic<std::uint32_t> umbc::Log::dequeue_position;
+std::atomic<std::uint32_t> umbc::Log::dropped;
+std::atomic<std::uint32_t> umbc::Log::stopping;
+std::string umbc::Log::file_path;
+std::unique_ptr<Task> umbc::Log::t_drain;
+
+umbc::Log::Entry* umbc::Log::reserve(log_module module, log_level level, const char* format) {
+
+    std::uint32_t position = enqueue_position.load(std::memory_order_relaxed);
+
+    while (true) {
+        std::uint32_t index = position % number_of_entries;
+        Entry* entry = &entries[index];
+        std::int32_t difference =
+            (std::int32_t)(entry->sequence.load(std::memory_order_acquire) + index - position);
+
+        if (0 == difference) {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (0 > difference) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        } else {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    Entry* entry = &entries[position % number_of_entries];
+    task_t task = pros::c::task_get_current();
+
+    entry->format = format;
+    entry->time_ms = pros::millis();
+    entry->module = module;
+    entry->level = level;
+    entry->size = 0;
+    entry->truncated = 0;
+
+    // logging before the scheduler starts has no task
+    entry->task[0] = '\0';
+    if (nullptr != task) {
+        std::strncpy(entry->task, pros::c::task_get_name(task), task_name_size - 1);
+        entry->task[task_name_size - 1] = '\0';
+    }
+
+    return entry;
+}
+
+void umbc::Log::commit(Entry* entry) {
+
+    std::uint32_t index = entry - entries;
+    std::uint32_t position = entry->sequence.load(std::memory_order_relaxed) + index;
+
+    entry->sequence.store(position + 1 - index, std::memory_order_release);
+}
+
+void umbc::Log::pack(Entry* entry, argument_type type, const void* data, std::uint32_t size) {
+
+    std::uint32_t space = payload_size - entry->size;
+    std::uint8_t* payload = &entry->payload[entry->size];
+
+    if (entry->truncated) {
+        return;
+    }
+
+    if (ARGUMENT_STRING == type) {
+        if (2 > space) {
+            entry->truncated = 1;
+            return;
+        }
+
+        std::uint32_t length = (space - 2 < size) ? space - 2 : size;
+        length = (UINT8_MAX < length) ? UINT8_MAX : length;
+        entry->truncated = (length < size);
+
+        payload[0] = type;
+        payload[1] = length;
+        std::memcpy(&payload[2], data, length);
+        entry->size += 2 + length;
+    } else {
+        if (1 + size > space) {
+            entry->truncated = 1;
+            return;
+        }
+
+        payload[0] = type;
+        std::memcpy(&payload[1], data, size);
+        entry->size += 1 + size;
+    }
+}
+
+void umbc::Log::format(const Entry* entry, char* text, std::uint32_t text_size) {
+
+    const char* format = entry->format;
+    std::uint32_t length = 0;
+    std::uint32_t offset = 0;
+
+    auto append = [&](std::int32_t written) {
+        if (0 < written) {
+            length += written;
+            length = (text_size - 1 < length) ? text_size - 1 : length;
+        }
+    };
+
+    text[0] = '\0';
+
+    while ('\0' != *format && length < text_size - 1) {
+
+        if ('%' != *format) {
+            text[length++] = *format++;
+            text[length] = '\0';
+            continue;
+        }
+
+        if ('%' == format[1]) {
+            text[length++] = '%';
+            text[length] = '\0';
+            format += 2;
+            continue;
+        }
+
+        // copy the flags, width and precision, drop the length modifier
+        char spec[24] = "%";
+        std::uint32_t spec_length = 1;
+        const char* conversion = format + 1;
+
+        while (std::strchr("-+ #0123456789.", *conversion) && '\0' != *conversion && spec_length < 16) {
+            spec[spec_length++] = *conversion++;
+        }
+        while (std::strchr("hljztL", *conversion) && '\0' != *conversion) {
+            conversion++;
+        }
+
+        if ('\0' == *conversion) {
+            append(snprintf(&text[length], text_size - length, "%s", format));
+            break;
+        }
+        format = conversion + 1;
+
+        if (offset >= entry->size) {
+            append(snprintf(&text[length], text_size - length, "(missing)"));
+            continue;
+        }
+
+        // unpack the next argument
+        std::uint8_t type = entry->payload[offset];
+        std::int64_t signed_value = 0;
+        std::uint64_t unsigned_value = 0;
+        double double_value = 0;
+        char string_value[payload_size + 1] = "";
+
+        if (ARGUMENT_STRING == type) {
+            std::uint8_t string_length = entry->payload[offset + 1];
+            std::memcpy(string_value, &entry->payload[offset + 2], string_length);
+            string_value[string_length] = '\0';
+            offset += 2 + string_length;
+        } else {
+            std::memcpy(&unsigned_value, &entry->payload[offset + 1], sizeof(unsigned_value));
+            std::memcpy(&signed_value, &unsigned_value, sizeof(signed_value));
+            std::memcpy(&double_value, &unsigned_value, sizeof(double_value));
+            offset += 1 + sizeof(unsigned_value);
+
+            if (ARGUMENT_DOUBLE == type) {
+                signed_value = double_value;
+                unsigned_value = double_value;
+            } else {
+                double_value = (ARGUMENT_SIGNED == type) ? (double)signed_value : (double)unsigned_value;
+            }
+        }
+
+        // a string given for a number, or a number given for a string, is
+        // printed as is
+        if (ARGUMENT_STRING == type && 's' != *conversion) {
+            append(snprintf(&text[length], text_size - length, "%s", string_value));
+            continue;
+        }
+
+        switch (*conversion) {
+            case 'd':
+            case 'i':
+                std::strcpy(&spec[spec_length], "lld");
+                append(snprintf(&text[length], text_size - length, spec, (long long)signed_value));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                spec[spec_length] = 'l';
+                spec[spec_length + 1] = 'l';
+                spec[spec_length + 2] = *conversion;
+                spec[spec_length + 3] = '\0';
+                append(snprintf(&text[length], text_size - length, spec, (unsigned long long)unsigned_value));
+                break;
+            case 'c':
+                std::strcpy(&spec[spec_length], "c");
+                append(snprintf(&text[length], text_size - length, spec, (int)signed_value));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                spec[spec_length] = *conversion;
+                spec[spec_length + 1] = '\0';
+                append(snprintf(&text[length], text_size - length, spec, double_value));
+                break;
+            case 's':
+                if (ARGUMENT_STRING != type) {
+                    if (ARGUMENT_DOUBLE == type) {
+                        snprintf(string_value, sizeof(string_value), "%g", double_value);
+                    } else if (ARGUMENT_SIGNED == type) {
+                        snprintf(string_value, sizeof(string_value), "%lld", (long long)signed_value);
+                    } else {
+                        snprintf(string_value, sizeof(string_value), "%llu", (unsigned long long)unsigned_value);
+                    }
+                }
+                std::strcpy(&spec[spec_length], "s");
+                append(snprintf(&text[length], text_size - length, spec, string_value));
+                break;
+            case 'p':
+                append(snprintf(&text[length], text_size - length, "%p", (void*)(std::uintptr_t)unsigned_value));
+                break;
+            default:
+                append(snprintf(&text[length], text_size - length, "%%%c", *conversion));
+                break;
+        }
+    }
+
+    if (entry->truncated) {
+        append(snprintf(&text[length], text_size - length, " [truncated]"));
+    }
+}
+
+std::int32_t umbc::Log::drain_one(std::ostream* file) {
+
+    std::uint32_t position = dequeue_position.load(std::memory_order_relaxed);
+    Entry* entry = nullptr;
+
+    while (true) {
+        std::uint32_t index = position % number_of_entries;
+        entry = &entries[index];
+        std::int32_t difference =
+            (std::int32_t)(entry->sequence.load(std::memory_order_acquire) + index - (position + 1));
+
+        if (0 == difference) {
+            if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (0 > difference) {
+            return 0;
+        } else {
+            position = dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    char text[256];
+    char record[64];
+    std::ostream* out = (nullptr != file) ? file : &std::cout;
+
+    format(entry, text, sizeof(text));
+    snprintf(record, sizeof(record), "%u\t%s\t%s\t%s\t", (unsigned)entry->time_ms,
+        level_names[(LOG_LEVEL_NONE < entry->level) ? (std::uint8_t)LOG_LEVEL_NONE : entry->level],
+        (LOG_MODULE_COUNT > entry->module) ? module_names[entry->module] : "", entry->task);
+    if (LOG_LEVEL_ERROR == entry->level) {
+        out = (nullptr != file) ? file : &std::cerr;
+    }
+
+    // free the entry for the lap of the ring buffer after this one
+    entry->sequence.store(position + number_of_entries - (entry - entries), std::memory_order_release);
+
+    *out << record << text << "\n";
+
+    return 1;
+}
+
+void umbc::Log::drain(void* /* parameters */) {
+
+    std::unique_ptr<std::ofstream> file;
+
+    if (!file_path.empty()) {
+        file.reset(new std::ofstream(file_path, std::ofstream::app));
+        if (!file->good()) {
+            file.reset(nullptr);
+            WARN("could not open %s, logging to the terminal", file_path);
+        }
+    }
+
+    while (!stopping.load(std::memory_order_acquire)) {
+
+        while (drain_one(file.get()));
+
+        std::uint32_t count = get_dropped();
+        if (0 < count) {
+            WARN("%u log messages were dropped", count);
+        }
+
+        if (nullptr != file) {
+            file->flush();
+        } else {
+            std::cout.flush();
+            std::cerr.flush();
+        }
+
+        pros::Task::notify_take(true, drain_delay_ms);
+    }
+
+    while (drain_one(file.get()));
+    if (nullptr != file) {
+        file->close();
+    } else {
+        std::cout.flush();
+        std::cerr.flush();
+    }
+}
+
+void umbc::Log::start(const char* file_path) {
+
+    if (nullptr != t_drain) {
+        return;
+    }
+
+    Log::file_path = (nullptr != file_path) ? file_path : "";
+    stopping.store(0, std::memory_order_release);
+
+    try {
+        t_drain.reset(new Task((task_fn_t)drain, nullptr, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_DEFAULT,
+            t_drain_name));
+    } catch (...) {
+        std::cerr << "ERROR: failed to start " << t_drain_name << std::endl;
+    }
+}
+
+void umbc::Log::stop() {
+
+    Task* t_drain_task = t_drain.get();
+
+    if (nullptr == t_drain_task) {
+        return;
+    }
+
+    stopping.store(1, std::memory_order_release);
+    try {
+        t_drain_task->notify();
+        t_drain_task->join();
+    } catch (...) {
+        std::cerr << "ERROR: failed to stop " << t_drain_name << std::endl;
+    }
+    t_drain.reset(nullptr);
+}
+
+void umbc::Log::flush() {
+
+    while (drain_one(nullptr));
+
+    std::cout.flush();
+    std::cerr.flush();
+}
+
+std::uint32_t umbc::Log::get_dropped() {
+    return dropped.exchange(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,203 @@
+/**
+ * \file umbc/looptiming.cpp
+ *
+ * Contains the implementation of the LoopTiming. LoopTiming measures how late
+ * each iteration of a fixed period loop started and how long its body took.
+ */
+
+#define LOG_MODULE LOG_MODULE_TIMING
+
+#include "api.h"
+#include "umbc.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::LoopTiming::LoopTiming(const char* name, std::uint32_t period_ms) {
+
+    this->name = name;
+    this->reset(period_ms);
+}
+
+void umbc::LoopTiming::add(std::atomic<std::uint32_t>* histogram, std::uint32_t time_us) {
+
+    std::uint32_t bucket = time_us / this->bucket_us;
+    bucket = (number_of_buckets > bucket) ? bucket : number_of_buckets - 1;
+    histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint32_t umbc::LoopTiming::percentile(std::atomic<std::uint32_t>* histogram, std::uint32_t max_us,
+    float percentile) {
+
+    std::uint32_t total = 0;
+    for (std::uint32_t i = 0; i < number_of_buckets; i++) {
+        total += histogram[i].load(std::memory_order_relaxed);
+    }
+
+    if (0 == total) {
+        return 0;
+    }
+
+    std::uint32_t rank = std::ceil(total * percentile / 100);
+    std::uint32_t count = 0;
+    rank = (0 < rank) ? rank : 1;
+
+    for (std::uint32_t i = 0; i < number_of_buckets; i++) {
+        count += histogram[i].load(std::memory_order_relaxed);
+        if (rank <= count) {
+            std::uint32_t edge_us = (i + 1) * this->bucket_us;
+            return (max_us < edge_us) ? max_us : edge_us;
+        }
+    }
+
+    return max_us;
+}
+
+void umbc::LoopTiming::reset(std::uint32_t period_ms) {
+
+    this->period_us = period_ms * 1000;
+    this->bucket_us = 2 * this->period_us / number_of_buckets;
+    this->bucket_us = (0 < this->bucket_us) ? this->bucket_us : 1;
+    this->reset();
+}
+
+void umbc::LoopTiming::reset() {
+
+    this->start_us = 0;
+    this->started = 0;
+    this->iterations = 0;
+    this->overruns = 0;
+    this->max_lateness_us = 0;
+    this->max_duration_us = 0;
+
+    for (std::uint32_t i = 0; i < number_of_buckets; i++) {
+        this->lateness[i] = 0;
+        this->duration[i] = 0;
+    }
+}
+
+void umbc::LoopTiming::begin() {
+
+    std::uint64_t now_us = pros::micros();
+
+    // the first iteration has nothing to be late against
+    if (this->started) {
+        std::uint64_t interval_us = now_us - this->start_us;
+        std::uint32_t lateness_us = (this->period_us < interval_us) ? interval_us - this->period_us : 0;
+
+        this->add(this->lateness, lateness_us);
+        if (this->max_lateness_us < lateness_us) {
+            this->max_lateness_us = lateness_us;
+        }
+    }
+
+    this->start_us = now_us;
+    this->started = 1;
+}
+
+void umbc::LoopTiming::end() {
+
+    if (!this->started) {
+        return;
+    }
+
+    std::uint32_t duration_us = pros::micros() - this->start_us;
+
+    this->add(this->duration, duration_us);
+    if (this->max_duration_us < duration_us) {
+        this->max_duration_us = duration_us;
+    }
+    if (this->period_us < duration_us) {
+        this->overruns++;
+    }
+    this->iterations++;
+}
+
+std::uint32_t umbc::LoopTiming::get_iterations() {
+    return this->iterations;
+}
+
+std::uint32_t umbc::LoopTiming::get_overruns() {
+    return this->overruns;
+}
+
+std::uint32_t umbc::LoopTiming::get_max_lateness_us() {
+    return this->max_lateness_us;
+}
+
+std::uint32_t umbc::LoopTiming::get_max_duration_us() {
+    return this->max_duration_us;
+}
+
+std::uint32_t umbc::LoopTiming::get_lateness_percentile_us(float percentile) {
+    return this->percentile(this->lateness, this->max_lateness_us, percentile);
+}
+
+std::uint32_t umbc::LoopTiming::get_duration_percentile_us(float percentile) {
+    return this->percentile(this->duration, this->max_duration_us, percentile);
+}
+
+std::string umbc::LoopTiming::summary() {
+
+    return string(this->name) + ": " + std::to_string(this->get_iterations()) + " iterations at "
+        + std::to_string(this->period_us) + "us, " + std::to_string(this->get_overruns()) + " overruns, late p50 "
+        + std::to_string(this->get_lateness_percentile_us(50)) + "us p99 "
+        + std::to_string(this->get_lateness_percentile_us(99)) + "us max "
+        + std::to_string(this->get_max_lateness_us()) + "us, body p50 "
+        + std::to_string(this->get_duration_percentile_us(50)) + "us p99 "
+        + std::to_string(this->get_duration_percentile_us(99)) + "us max "
+        + std::to_string(this->get_max_duration_us()) + "us";
+}
+
+void umbc::LoopTiming::print() {
+
+    // the same line as summary, formatted by the log drain instead
+    const char* format = "%s: %u iterations at %uus, %u overruns, late p50 %uus p99 %uus max %uus, "
+        "body p50 %uus p99 %uus max %uus";
+
+    if (0 < this->get_overruns()) {
+        WARN(format, this->name, this->get_iterations(), this->period_us, this->get_overruns(),
+            this->get_lateness_percentile_us(50), this->get_lateness_percentile_us(99), this->get_max_lateness_us(),
+            this->get_duration_percentile_us(50), this->get_duration_percentile_us(99), this->get_max_duration_us());
+    } else {
+        INFO(format, this->name, this->get_iterations(), this->period_us, this->get_overruns(),
+            this->get_lateness_percentile_us(50), this->get_lateness_percentile_us(99), this->get_max_lateness_us(),
+            this->get_duration_percentile_us(50), this->get_duration_percentile_us(99), this->get_max_duration_us());
+    }
+}
+
+std::int32_t umbc::LoopTiming::save(const char* file_path) {
+
+    string file_path_str = string(file_path);
+
+    std::ofstream file(file_path);
+    if (!file.good()) {
+        file.close();
+        ERROR("could not open %s", file_path_str);
+        return 0;
+    }
+
+    file << "# " << this->summary() << "\n";
+    file << "upper_us,late,body\n";
+    for (std::uint32_t i = 0; i < number_of_buckets; i++) {
+        file << (i + 1) * this->bucket_us << "," << this->lateness[i].load(std::memory_order_relaxed) << ","
+            << this->duration[i].load(std::memory_order_relaxed) << "\n";
+    }
+
+    if (!file.good()) {
+        file.close();
+        ERROR("failed to write loop timing to %s", file_path_str);
+        return 0;
+    }
+    file.close();
+    INFO("loop timing of %s written to %s", this->name, file_path_str);
+
+    return 1;
+}
@@ -0,0 +1,149 @@
+/**
+ * \file umbc/menu.cpp
+ *
+ * Contains the implementation of the Menu. The Menu is a table of LLEMU
+ * screens walked by a state machine that sleeps until a button is pressed.
+ */
+
+#define LOG_MODULE LOG_MODULE_ROBOT
+
+#include "api.h"
+#include "umbc.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stack>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+std::atomic<pros::c::sem_t> umbc::Menu::button_semaphore(nullptr);
+std::atomic<std::uint32_t> umbc::Menu::pressed_buttons(0);
+
+umbc::Menu::Menu() {}
+
+void umbc::Menu::press(std::uint32_t button) {
+
+    pros::c::sem_t semaphore = button_semaphore.load();
+
+    if (nullptr != semaphore) {
+        pressed_buttons.fetch_or(button);
+        pros::c::sem_post(semaphore);
+    }
+}
+
+void umbc::Menu::press_left() {
+    press(LCD_BTN_LEFT);
+}
+
+void umbc::Menu::press_center() {
+    press(LCD_BTN_CENTER);
+}
+
+void umbc::Menu::press_right() {
+    press(LCD_BTN_RIGHT);
+}
+
+void umbc::Menu::draw(const Screen& screen, std::uint32_t cursor) {
+
+    std::uint32_t first_visible = (number_of_visible_items <= cursor) ? cursor - number_of_visible_items + 1 : 0;
+
+    pros::lcd::clear();
+    pros::lcd::set_text(title_line, screen.title);
+
+    for (std::uint32_t i = 0; i < number_of_visible_items && first_visible + i < screen.items.size(); i++) {
+        std::uint32_t item = first_visible + i;
+        pros::lcd::set_text(first_item_line + i, ((cursor == item) ? "> " : "  ") + screen.items[item].label);
+    }
+}
+
+void umbc::Menu::set_screen(std::int32_t screen, const std::string& title) {
+    this->screens[screen].title = title;
+}
+
+void umbc::Menu::add_item(std::int32_t screen, const std::string& label, std::int32_t next,
+    std::function<void(void)> select) {
+    this->screens[screen].items.push_back({label, next, select});
+}
+
+void umbc::Menu::clear_items(std::int32_t screen) {
+    this->screens[screen].items.clear();
+}
+
+std::int32_t umbc::Menu::run(std::int32_t screen) {
+
+    std::stack<std::int32_t> previous;
+    std::uint32_t cursor = 0;
+
+    if (!pros::lcd::is_initialized()) {
+        return 0;
+    }
+
+    if (this->screens[screen].items.empty()) {
+        ERROR("menu screen %d has no items", screen);
+        return 0;
+    }
+
+    // the semaphore is never deleted, a callback may still post to it
+    // after the task that ran the last menu was deleted
+    if (nullptr == button_semaphore.load()) {
+        button_semaphore.store(pros::c::sem_binary_create());
+    }
+    pros::lcd::register_btn0_cb(press_left);
+    pros::lcd::register_btn1_cb(press_center);
+    pros::lcd::register_btn2_cb(press_right);
+
+    // drop presses from before this menu
+    while (pros::c::sem_wait(button_semaphore.load(), 0)) {}
+    pressed_buttons.store(0);
+
+    this->draw(this->screens[screen], cursor);
+
+    while (1) {
+
+        pros::c::sem_wait(button_semaphore.load(), TIMEOUT_MAX);
+        std::uint32_t buttons = pressed_buttons.exchange(0);
+        const std::vector<MenuItem>& items = this->screens[screen].items;
+
+        if (LCD_BTN_LEFT & buttons) {
+            cursor = (0 < cursor) ? cursor - 1 : items.size() - 1;
+        } else if (LCD_BTN_RIGHT & buttons) {
+            cursor = (items.size() - 1 > cursor) ? cursor + 1 : 0;
+        } else if (LCD_BTN_CENTER & buttons) {
+            MenuItem item = items[cursor];
+            std::int32_t next = item.next;
+
+            if (item.select) {
+                item.select();
+            }
+
+            if (MENU_DONE == next) {
+                break;
+            } else if (MENU_BACK == next) {
+                if (!previous.empty()) {
+                    screen = previous.top();
+                    previous.pop();
+                }
+            } else if (this->screens[next].items.empty()) {
+                ERROR("menu screen %d has no items", next);
+            } else {
+                previous.push(screen);
+                screen = next;
+            }
+            cursor = 0;
+        } else {
+            continue;
+        }
+
+        this->draw(this->screens[screen], cursor);
+    }
+
+    pros::lcd::clear();
+
+    return 1;
+}
@@ -14,7 +14,7 @@ using namespace pros;
 using namespace umbc;
 using namespace std;
 
-umbc::PController::PController(controller_id_e_t id) : controller(id) {
+umbc::PController::PController(controller_id_e_t id) : id(id), controller(id) {
     // intentionally blank
 }
 
@@ -42,6 +42,28 @@ std::int32_t umbc::PController::get_digital_new_press(controller_digital_e_t but
     return this->controller.get_digital_new_press(button);
 }
 
+ControllerInput umbc::PController::snapshot() {
+
+    std::uint16_t buttons = 0;
+    std::int8_t axes[ControllerInput::number_of_analogs] = {0};
+
+    if (1 != pros::c::controller_is_connected(this->id)) {
+        return ControllerInput(buttons, axes);
+    }
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_digitals; i++) {
+        buttons |= (1 == pros::c::controller_get_digital(this->id,
+            (controller_digital_e_t)(E_CONTROLLER_DIGITAL_L1 + i))) << i;
+    }
+
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        std::int32_t value = pros::c::controller_get_analog(this->id, (controller_analog_e_t)i);
+        axes[i] = (PROS_ERR == value) ? 0 : value;
+    }
+
+    return ControllerInput(buttons, axes);
+}
+
 template <typename... Params> std::int32_t umbc::PController::print(std::uint8_t line, std::uint8_t col, const char* fmt, Params... args) {
     return this-controller.print(line, col, fmt, args...);
 }
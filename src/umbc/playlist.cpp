@@ -0,0 +1,140 @@
+/**
+ * \file umbc/playlist.cpp
+ *
+ * Contains the implementation of the Playlist. A Playlist lists recorded
+ * controller input files (clips) to be played back one after another.
+ */
+
+#define LOG_MODULE LOG_MODULE_RECORDING
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+static constexpr char playlist_magic[4] = {'U', 'M', 'B', 'P'};
+static constexpr std::uint8_t playlist_version = 1;
+static constexpr std::size_t playlist_header_size = 8;
+static constexpr std::size_t clip_header_size = 3;
+
+umbc::Playlist::Playlist() {
+
+    this->clips = std::vector<std::string>();
+    this->gaps = std::vector<std::uint16_t>();
+}
+
+std::int32_t umbc::Playlist::is_playlist(const std::uint8_t* data, std::size_t size) {
+
+    return playlist_header_size <= size && 0 == data[0] && 0 == data[1]
+        && 0 == std::memcmp(&(data[2]), playlist_magic, sizeof(playlist_magic));
+}
+
+std::int32_t umbc::Playlist::add(const char* clip_path, std::uint16_t gap_ms) {
+
+    if (max_clips <= this->clips.size() || max_path_length < std::strlen(clip_path)) {
+        ERROR("could not add %s to playlist", clip_path);
+        return 0;
+    }
+
+    this->clips.push_back(string(clip_path));
+    this->gaps.push_back(gap_ms);
+
+    return 1;
+}
+
+void umbc::Playlist::clear() {
+
+    this->clips.clear();
+    this->gaps.clear();
+}
+
+std::int32_t umbc::Playlist::parse(const std::uint8_t* data, std::size_t size) {
+
+    this->clear();
+
+    if (!is_playlist(data, size) || playlist_version != data[6]) {
+        return 0;
+    }
+
+    std::uint32_t number_of_clips = data[7];
+    std::size_t offset = playlist_header_size;
+
+    for (std::uint32_t i = 0; i < number_of_clips; i++) {
+
+        if (clip_header_size > size - offset) {
+            this->clear();
+            return 0;
+        }
+
+        std::uint16_t gap_ms = data[offset] | (data[offset + 1] << 8);
+        std::size_t path_length = data[offset + 2];
+        offset += clip_header_size;
+
+        if (path_length > size - offset) {
+            this->clear();
+            return 0;
+        }
+
+        this->clips.push_back(string((const char*)&(data[offset]), path_length));
+        this->gaps.push_back(gap_ms);
+        offset += path_length;
+    }
+
+    return 1;
+}
+
+std::int32_t umbc::Playlist::save(const char* file_path) {
+
+    string file_path_str = string(file_path);
+    std::vector<std::uint8_t> manifest(playlist_header_size, 0);
+
+    std::memcpy(&(manifest[2]), playlist_magic, sizeof(playlist_magic));
+    manifest[6] = playlist_version;
+    manifest[7] = this->clips.size();
+
+    for (std::uint32_t i = 0; i < this->clips.size(); i++) {
+        manifest.push_back(this->gaps[i] & 0xFF);
+        manifest.push_back(this->gaps[i] >> 8);
+        manifest.push_back(this->clips[i].size());
+        manifest.insert(manifest.end(), this->clips[i].begin(), this->clips[i].end());
+    }
+
+    std::ofstream file(file_path, std::ofstream::binary);
+    if (!file.good()) {
+        file.close();
+        ERROR("could not open %s", file_path_str);
+        return 0;
+    }
+
+    file.write((const char*)manifest.data(), manifest.size());
+    if (!file.good()) {
+        file.close();
+        ERROR("failed to write playlist to %s", file_path_str);
+        return 0;
+    }
+    file.close();
+    INFO("playlist of %u clips written to %s", this->clips.size(), file_path_str);
+
+    return 1;
+}
+
+std::uint32_t umbc::Playlist::size() {
+    return this->clips.size();
+}
+
+const std::string& umbc::Playlist::get_clip(std::uint32_t clip) {
+    return this->clips[clip];
+}
+
+std::uint16_t umbc::Playlist::get_gap(std::uint32_t clip) {
+    return this->gaps[clip];
+}
@@ -0,0 +1,94 @@
+/**
+ * \file umbc/posecorrection.cpp
+ *
+ * Contains the implementation of the PoseCorrection. PoseCorrection adds a
+ * proportional correction towards the recorded pose to the drive sticks of
+ * the replayed controller input.
+ */
+
+#define LOG_MODULE LOG_MODULE_POSE
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::PoseCorrection::PoseCorrection(okapi::Odometry* odometry, std::shared_ptr<PoseTrack> pose_track,
+    correction_drive drive, float kp_forward, float kp_lateral, float kp_turn, std::uint8_t max_correction) {
+
+    this->odometry = odometry;
+    this->pose_track = pose_track;
+    this->drive = drive;
+    this->kp_forward = kp_forward;
+    this->kp_lateral = kp_lateral;
+    this->kp_turn = kp_turn;
+    this->max_correction = max_correction;
+}
+
+void umbc::PoseCorrection::start(std::uint32_t frame) {
+
+    if (nullptr == this->odometry || nullptr == this->pose_track.get() || frame >= this->pose_track->size()) {
+        return;
+    }
+
+    this->odometry->setState(this->pose_track->get_pose(frame));
+    INFO("odometry set to the pose recorded at frame %u", frame);
+}
+
+void umbc::PoseCorrection::correct(std::uint32_t frame, ControllerInput& controller_input) {
+
+    if (nullptr == this->odometry || nullptr == this->pose_track.get() || frame >= this->pose_track->size()) {
+        return;
+    }
+
+    okapi::OdomState target = this->pose_track->get_pose(frame);
+    okapi::OdomState state = this->odometry->getState();
+
+    // +x is forward, +y is right and the heading turns clockwise, so the
+    // error is rotated into the frame of the robot
+    double theta = state.theta.convert(okapi::radian);
+    double dx = (target.x - state.x).convert(okapi::millimeter);
+    double dy = (target.y - state.y).convert(okapi::millimeter);
+    double forward_error = dx * std::cos(theta) + dy * std::sin(theta);
+    double lateral_error = dy * std::cos(theta) - dx * std::sin(theta);
+    double heading_error = std::remainder((target.theta - state.theta).convert(okapi::degree), 360.0);
+
+    double forward = this->kp_forward * forward_error;
+    double turn = this->kp_lateral * lateral_error + this->kp_turn * heading_error;
+
+    forward = (this->max_correction < forward) ? this->max_correction
+        : ((-this->max_correction > forward) ? -this->max_correction : forward);
+    turn = (this->max_correction < turn) ? this->max_correction
+        : ((-this->max_correction > turn) ? -this->max_correction : turn);
+
+    std::int32_t forward_correction = std::lround(forward);
+    std::int32_t turn_correction = std::lround(turn);
+
+    switch (this->drive) {
+        case CORRECTION_SINGLE_ARCADE:
+            controller_input.set_analog(E_CONTROLLER_ANALOG_LEFT_Y,
+                controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_Y) + forward_correction);
+            controller_input.set_analog(E_CONTROLLER_ANALOG_LEFT_X,
+                controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_X) + turn_correction);
+            break;
+        case CORRECTION_TANK:
+            controller_input.set_analog(E_CONTROLLER_ANALOG_LEFT_Y,
+                controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_Y) + forward_correction + turn_correction);
+            controller_input.set_analog(E_CONTROLLER_ANALOG_RIGHT_Y,
+                controller_input.get_analog(E_CONTROLLER_ANALOG_RIGHT_Y) + forward_correction - turn_correction);
+            break;
+        default:
+            controller_input.set_analog(E_CONTROLLER_ANALOG_LEFT_Y,
+                controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_Y) + forward_correction);
+            controller_input.set_analog(E_CONTROLLER_ANALOG_RIGHT_X,
+                controller_input.get_analog(E_CONTROLLER_ANALOG_RIGHT_X) + turn_correction);
+            break;
+    }
+}
@@ -0,0 +1,185 @@
+/**
+ * \file umbc/posetrack.cpp
+ *
+ * Contains the implementation of the PoseTrack. A PoseTrack holds the
+ * odometry pose of the robot for every frame of a recording.
+ */
+
+#define LOG_MODULE LOG_MODULE_POSE
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+static constexpr char pose_track_magic[4] = {'U', 'M', 'B', 'O'};
+static constexpr std::uint8_t pose_track_version = 1;
+
+/**
+ * Rounds a value to the nearest int16_t, saturating at the limits.
+ */
+static std::int16_t to_int16(double value) {
+
+    value = std::round(value);
+    if (INT16_MAX < value) {
+        return INT16_MAX;
+    } else if (INT16_MIN > value) {
+        return INT16_MIN;
+    }
+    return (std::int16_t)value;
+}
+
+umbc::PoseTrack::PoseTrack(std::uint16_t poll_rate_ms) {
+
+    this->poll_rate_ms = poll_rate_ms;
+    this->poses = std::vector<std::int16_t>();
+}
+
+std::string umbc::PoseTrack::path_for(const std::string& file_path) {
+
+    std::size_t extension = file_path.find_last_of('.');
+    std::size_t directory = file_path.find_last_of('/');
+
+    if (std::string::npos == extension || (std::string::npos != directory && extension < directory)) {
+        return file_path + ".pose";
+    }
+    return file_path.substr(0, extension) + ".pose";
+}
+
+void umbc::PoseTrack::push(const okapi::OdomState& state) {
+
+    double theta = std::remainder(state.theta.convert(okapi::degree), 360.0);
+
+    this->poses.push_back(to_int16(state.x.convert(okapi::millimeter)));
+    this->poses.push_back(to_int16(state.y.convert(okapi::millimeter)));
+    this->poses.push_back(to_int16((180.0 <= theta) ? -18000.0 : theta * 100));
+}
+
+void umbc::PoseTrack::reserve(std::uint32_t number_of_poses) {
+    this->poses.reserve(3 * number_of_poses);
+}
+
+std::int32_t umbc::PoseTrack::save(const char* file_path) {
+
+    string file_path_str = string(file_path);
+    std::uint32_t number_of_poses = this->size();
+    std::vector<std::uint8_t> buffer(header_size + pose_size * number_of_poses, 0);
+
+    std::memcpy(&(buffer[2]), pose_track_magic, sizeof(pose_track_magic));
+    buffer[6] = pose_track_version;
+    buffer[8] = this->poll_rate_ms & 0xFF;
+    buffer[9] = this->poll_rate_ms >> 8;
+    for (std::uint32_t i = 0; i < 4; i++) {
+        buffer[10 + i] = (number_of_poses >> (8 * i)) & 0xFF;
+    }
+
+    std::uint8_t* pose = &(buffer[header_size]);
+    for (std::int16_t value : this->poses) {
+        *(pose++) = (std::uint16_t)value & 0xFF;
+        *(pose++) = (std::uint16_t)value >> 8;
+    }
+
+    std::ofstream file(file_path, std::ofstream::binary);
+    if (!file.good()) {
+        file.close();
+        ERROR("could not open %s", file_path_str);
+        return -1;
+    }
+
+    file.write((const char*)buffer.data(), buffer.size());
+    if (!file.good()) {
+        file.close();
+        ERROR("failed to write pose track to %s", file_path_str);
+        return -1;
+    }
+    file.close();
+    INFO("%u poses written to %s", number_of_poses, file_path_str);
+
+    return number_of_poses;
+}
+
+std::int32_t umbc::PoseTrack::load(const char* file_path) {
+
+    this->clear();
+
+    string file_path_str = string(file_path);
+
+    std::ifstream file(file_path, std::ifstream::binary | std::ifstream::ate);
+    if (!file.good()) {
+        file.close();
+        ERROR("could not open %s", file_path_str);
+        return 0;
+    }
+
+    std::streamoff file_size = file.tellg();
+    std::vector<std::uint8_t> buffer(0 < file_size ? file_size : 0);
+
+    file.seekg(0, std::ifstream::beg);
+    file.read((char*)buffer.data(), buffer.size());
+    if (0 >= file_size || !file.good()) {
+        file.close();
+        ERROR("failed to read %s", file_path_str);
+        return 0;
+    }
+    file.close();
+
+    if (header_size > buffer.size() || 0 != buffer[0] || 0 != buffer[1]
+        || 0 != std::memcmp(&(buffer[2]), pose_track_magic, sizeof(pose_track_magic))
+        || pose_track_version != buffer[6]) {
+        ERROR("invalid header in %s", file_path_str);
+        return 0;
+    }
+
+    std::uint16_t poll_rate_ms = buffer[8] | (buffer[9] << 8);
+    std::uint32_t number_of_poses = 0;
+    for (std::uint32_t i = 0; i < 4; i++) {
+        number_of_poses |= (std::uint32_t)buffer[10 + i] << (8 * i);
+    }
+
+    if (0 == poll_rate_ms || number_of_poses > (buffer.size() - header_size) / pose_size) {
+        ERROR("truncated pose track in %s", file_path_str);
+        return 0;
+    }
+
+    this->poses.resize(3 * number_of_poses);
+    const std::uint8_t* pose = &(buffer[header_size]);
+    for (std::uint32_t i = 0; i < this->poses.size(); i++, pose += 2) {
+        this->poses[i] = (std::int16_t)(pose[0] | (pose[1] << 8));
+    }
+    this->poll_rate_ms = poll_rate_ms;
+    INFO("%u poses loaded from %s", number_of_poses, file_path_str);
+
+    return 1;
+}
+
+void umbc::PoseTrack::clear() {
+    this->poses.clear();
+}
+
+std::uint32_t umbc::PoseTrack::size() {
+    return this->poses.size() / 3;
+}
+
+std::uint16_t umbc::PoseTrack::get_poll_rate() {
+    return this->poll_rate_ms;
+}
+
+okapi::OdomState umbc::PoseTrack::get_pose(std::uint32_t frame) {
+
+    okapi::OdomState state;
+
+    state.x = this->poses[3 * frame] * okapi::millimeter;
+    state.y = this->poses[3 * frame + 1] * okapi::millimeter;
+    state.theta = (this->poses[3 * frame + 2] / 100.0) * okapi::degree;
+
+    return state;
+}
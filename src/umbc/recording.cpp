@@ -0,0 +1,250 @@
+/**
+ * \file umbc/recording.cpp
+ *
+ * Contains the implementation of the Recording. A Recording holds the
+ * decoded contents of a controller input file as events so it can be loaded
+ * ahead of time and handed to a VController for playback.
+ */
+
+#define LOG_MODULE LOG_MODULE_RECORDING
+
+#include "api.h"
+#include "umbc.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::Recording::Recording() {
+
+    this->poll_rate_ms = 0;
+    this->controller_id = E_CONTROLLER_MASTER;
+    this->events = std::vector<ControllerInput>();
+    this->event_frames = std::vector<std::uint32_t>();
+    this->event_times = std::vector<std::uint32_t>();
+    this->number_of_frames = 0;
+}
+
+std::int32_t umbc::Recording::load(const char* file_path) {
+    return this->load(file_path, 0);
+}
+
+std::int32_t umbc::Recording::load(const char* file_path, std::uint32_t depth) {
+
+    this->clear();
+
+    string file_path_str = string(file_path);
+
+    std::ifstream file(file_path, std::ifstream::binary | std::ifstream::ate);
+    if (!file.good()) {
+        file.close();
+        ERROR("could not open %s", file_path_str);
+        return 0;
+    }
+
+    std::streamoff file_size = file.tellg();
+    std::vector<std::uint8_t> file_buffer(0 < file_size ? file_size : 0);
+
+    INFO("reading %s...", file_path_str);
+    file.seekg(0, std::ifstream::beg);
+    file.read((char*)file_buffer.data(), file_buffer.size());
+    if (0 >= file_size || !file.good()) {
+        file.close();
+        ERROR("failed to read %s", file_path_str);
+        return 0;
+    }
+    file.close();
+
+    if (Playlist::is_playlist(file_buffer.data(), file_buffer.size())) {
+        return this->load_playlist(file_buffer.data(), file_buffer.size(), file_path, depth);
+    }
+
+    InputDecoder decoder(file_buffer.data(), file_buffer.size());
+    std::uint16_t poll_rate_ms = 0;
+
+    INFO("reading header from %s...", file_path_str);
+    std::int32_t version = decoder.read_header(poll_rate_ms);
+    if (0 == version) {
+        ERROR("invalid or corrupt header in %s", file_path_str);
+        return 0;
+    }
+    INFO("file format version is %d", version);
+    INFO("poll rate is %ums", poll_rate_ms);
+
+    std::int32_t number_of_controller_inputs = decoder.count();
+    if (0 > number_of_controller_inputs) {
+        ERROR("failed to read controller data from %s", file_path_str);
+        return 0;
+    }
+
+    INFO("loading in controller data from %s...", file_path_str);
+    ControllerInput controller_input;
+    std::uint32_t timestamp = 0;
+    std::int16_t jitter_ms;
+    for (std::int32_t i = 0; i < number_of_controller_inputs; i++) {
+        // the frame count of the header is trusted by count, so the body can
+        // still run out early
+        if (1 != decoder.next(controller_input, jitter_ms)) {
+            this->clear();
+            ERROR("failed to read controller input %d of %d from %s", i, number_of_controller_inputs,
+                file_path_str);
+            return 0;
+        }
+
+        // the first controller input starts the timeline
+        std::int32_t interval_ms = (0 == i) ? 0 : poll_rate_ms + jitter_ms;
+        timestamp += (0 < interval_ms) ? interval_ms : 0;
+
+        // frames within an event are exactly one poll rate apart
+        if (this->events.empty() || controller_input != this->events.back() || 0 != jitter_ms) {
+            this->events.push_back(controller_input);
+            this->event_frames.push_back(i);
+            this->event_times.push_back(timestamp);
+        }
+    }
+    this->events.shrink_to_fit();
+    this->event_frames.shrink_to_fit();
+    this->event_times.shrink_to_fit();
+    this->number_of_frames = number_of_controller_inputs;
+    INFO("%u frames in %u events", this->number_of_frames, this->events.size());
+    this->poll_rate_ms = poll_rate_ms;
+    this->controller_id = decoder.get_controller_id();
+    INFO("controller data from %s loaded successfully", file_path_str);
+
+    return 1;
+}
+
+std::int32_t umbc::Recording::load_playlist(const std::uint8_t* data, std::size_t size,
+    const char* file_path, std::uint32_t depth) {
+
+    string file_path_str = string(file_path);
+    Playlist playlist;
+
+    if (!playlist.parse(data, size)) {
+        ERROR("invalid playlist in %s", file_path_str);
+        return 0;
+    }
+
+    if (max_playlist_depth <= depth) {
+        ERROR("playlists nested too deeply at %s", file_path_str);
+        return 0;
+    }
+
+    INFO("loading %u clips from %s...", playlist.size(), file_path_str);
+    for (std::uint32_t i = 0; i < playlist.size(); i++) {
+
+        Recording clip;
+
+        if (!clip.load(playlist.get_clip(i).c_str(), depth + 1) || !this->append(clip, playlist.get_gap(i))) {
+            this->clear();
+            ERROR("failed to load clip %s from %s", playlist.get_clip(i), file_path_str);
+            return 0;
+        }
+    }
+    INFO("playlist %s loaded successfully", file_path_str);
+
+    return 1;
+}
+
+std::int32_t umbc::Recording::append(const Recording& clip, std::uint32_t gap_ms) {
+
+    if (0 == this->poll_rate_ms) {
+        this->poll_rate_ms = clip.poll_rate_ms;
+        this->controller_id = clip.controller_id;
+    } else if (clip.poll_rate_ms != this->poll_rate_ms) {
+        ERROR("clip poll rate of %ums does not match %ums", clip.poll_rate_ms, this->poll_rate_ms);
+        return 0;
+    }
+
+    if (0 == this->poll_rate_ms) {
+        return 1;
+    }
+
+    std::uint32_t time = this->get_duration();
+
+    if (0 < gap_ms) {
+        std::uint32_t gap_frames = (gap_ms + this->poll_rate_ms - 1) / this->poll_rate_ms;
+        this->events.push_back(ControllerInput());
+        this->event_frames.push_back(this->number_of_frames);
+        this->event_times.push_back(time);
+        this->number_of_frames += gap_frames;
+        time += gap_frames * this->poll_rate_ms;
+    }
+
+    for (std::uint32_t i = 0; i < clip.events.size(); i++) {
+        this->events.push_back(clip.events[i]);
+        this->event_frames.push_back(this->number_of_frames + clip.event_frames[i]);
+        this->event_times.push_back(time + clip.event_times[i]);
+    }
+    this->number_of_frames += clip.number_of_frames;
+
+    return 1;
+}
+
+void umbc::Recording::clear() {
+
+    this->poll_rate_ms = 0;
+    this->controller_id = E_CONTROLLER_MASTER;
+    this->events.clear();
+    this->event_frames.clear();
+    this->event_times.clear();
+    this->number_of_frames = 0;
+}
+
+std::uint16_t umbc::Recording::get_poll_rate() {
+    return this->poll_rate_ms;
+}
+
+controller_id_e_t umbc::Recording::get_controller_id() {
+    return this->controller_id;
+}
+
+std::uint32_t umbc::Recording::size() {
+    return this->number_of_frames;
+}
+
+std::uint32_t umbc::Recording::get_number_of_events() {
+    return this->events.size();
+}
+
+std::uint32_t umbc::Recording::find_event(std::uint32_t frame) {
+
+    std::vector<std::uint32_t>::iterator event =
+        std::upper_bound(this->event_frames.begin(), this->event_frames.end(), frame);
+    return (event - this->event_frames.begin()) - 1;
+}
+
+std::uint32_t umbc::Recording::find_event_at(std::uint32_t time_ms) {
+
+    std::vector<std::uint32_t>::iterator event =
+        std::upper_bound(this->event_times.begin(), this->event_times.end(), time_ms);
+    return (event == this->event_times.begin()) ? 0 : (event - this->event_times.begin()) - 1;
+}
+
+std::uint32_t umbc::Recording::get_duration() {
+
+    return (0 == this->number_of_frames) ? 0
+        : this->get_time(this->number_of_frames - 1, this->events.size() - 1) + this->poll_rate_ms;
+}
+
+const ControllerInput& umbc::Recording::get_event(std::uint32_t event) {
+    return this->events[event];
+}
+
+std::uint32_t umbc::Recording::get_event_frame(std::uint32_t event) {
+    return this->event_frames[event];
+}
+
+std::uint32_t umbc::Recording::get_time(std::uint32_t frame, std::uint32_t event) {
+    return this->event_times[event] + (frame - this->event_frames[event]) * this->poll_rate_ms;
+}
+
+const ControllerInput& umbc::Recording::get_frame(std::uint32_t frame) {
+    return this->events[this->find_event(frame)];
+}
@@ -0,0 +1,229 @@
+/**
+ * \file umbc/recordingcache.cpp
+ *
+ * Contains the implementation of the RecordingCache. The RecordingCache
+ * loads and decodes controller input files in a background task and keeps
+ * the resulting recordings keyed by file path, so playback can start
+ * without waiting on the SD card.
+ */
+
+#define LOG_MODULE LOG_MODULE_RECORDING
+
+#include "api.h"
+#include "umbc.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::RecordingCache::RecordingCache() {
+    this->t_preload.reset(nullptr);
+    this->preloaded = pros::c::sem_binary_create();
+    this->waiters = 0;
+}
+
+umbc::RecordingCache::~RecordingCache() {
+
+    Task* t_preload = this->t_preload.get();
+    if (nullptr != t_preload) {
+        try {
+            t_preload->remove();
+            DEBUG("%s is stopped", t_preload_name);
+        } catch (...) {
+            ERROR("failed to stop %s", t_preload_name);
+        }
+    }
+
+    pros::c::sem_delete(this->preloaded);
+}
+
+/**
+ * Loads the pose track saved next to a controller input file.
+ */
+static std::shared_ptr<PoseTrack> load_pose_track(const std::string& file_path) {
+
+    string pose_track_path = PoseTrack::path_for(file_path);
+
+    // most files have no pose track, do not log a failed open for them
+    std::ifstream file(pose_track_path, std::ifstream::binary);
+    if (!file.good()) {
+        return nullptr;
+    }
+    file.close();
+
+    std::shared_ptr<PoseTrack> pose_track = std::make_shared<PoseTrack>();
+    if (!pose_track->load(pose_track_path.c_str())) {
+        pose_track.reset();
+    }
+
+    return pose_track;
+}
+
+void umbc::RecordingCache::preload_pending(void* RecordingCache) {
+
+    umbc::RecordingCache* cache = (umbc::RecordingCache*)RecordingCache;
+
+    while (1) {
+
+        cache->mutex.take(TIMEOUT_MAX);
+        if (cache->pending.empty()) {
+            cache->mutex.give();
+            pros::Task::notify_take(true, TIMEOUT_MAX);
+            continue;
+        }
+        string file_path = cache->pending.front();
+        cache->mutex.give();
+
+        cache->load(file_path);
+
+        cache->mutex.take(TIMEOUT_MAX);
+        cache->pending.erase(cache->pending.begin());
+        std::uint32_t waiters = cache->waiters;
+        cache->mutex.give();
+
+        if (0 < waiters) {
+            pros::c::sem_post(cache->preloaded);
+        }
+
+        DEBUG("preloaded %s", file_path);
+    }
+}
+
+void umbc::RecordingCache::load(const std::string& file_path) {
+
+    std::shared_ptr<Recording> recording = std::make_shared<Recording>();
+    if (!recording->load(file_path.c_str())) {
+        recording.reset();
+    }
+    std::shared_ptr<PoseTrack> pose_track = (nullptr != recording.get()) ? load_pose_track(file_path) : nullptr;
+
+    this->mutex.take(TIMEOUT_MAX);
+    this->recordings[file_path] = recording;
+    this->pose_tracks[file_path] = pose_track;
+    this->mutex.give();
+}
+
+std::int32_t umbc::RecordingCache::wait_for(const std::string& file_path) {
+
+    std::uint32_t start_ms = pros::millis();
+
+    while (1) {
+
+        this->mutex.take(TIMEOUT_MAX);
+
+        if (this->recordings.end() != this->recordings.find(file_path)) {
+            this->mutex.give();
+            return 1;
+        }
+
+        if (this->pending.end() == std::find(this->pending.begin(), this->pending.end(), file_path)) {
+            this->mutex.give();
+            return 0;
+        }
+
+        std::uint32_t waited_ms = pros::millis() - start_ms;
+        if (wait_timeout_ms <= waited_ms) {
+            this->mutex.give();
+            WARN("timed out waiting for %s to be preloaded", file_path);
+            return -1;
+        }
+
+        this->waiters++;
+        this->mutex.give();
+
+        pros::c::sem_wait(this->preloaded, wait_timeout_ms - waited_ms);
+
+        this->mutex.take(TIMEOUT_MAX);
+        this->waiters--;
+        std::uint32_t waiters = this->waiters;
+        this->mutex.give();
+
+        // the file finished may be the one another task is waiting for
+        if (0 < waiters) {
+            pros::c::sem_post(this->preloaded);
+        }
+    }
+}
+
+void umbc::RecordingCache::preload(const char* file_path) {
+
+    string file_path_str = string(file_path);
+
+    this->mutex.take(TIMEOUT_MAX);
+    if (this->recordings.end() == this->recordings.find(file_path_str)
+        && this->pending.end() == std::find(this->pending.begin(), this->pending.end(), file_path_str)) {
+        this->pending.push_back(file_path_str);
+    }
+    this->mutex.give();
+
+    if (nullptr == this->t_preload.get()) {
+        this->t_preload.reset(
+            new Task((task_fn_t)this->preload_pending, (void*)this, TASK_PRIORITY_DEFAULT - 1,
+                TASK_STACK_DEPTH_DEFAULT, this->t_preload_name));
+        DEBUG("%s has started", t_preload_name);
+    }
+
+    this->t_preload->notify();
+}
+
+std::shared_ptr<Recording> umbc::RecordingCache::get(const char* file_path) {
+
+    string file_path_str = string(file_path);
+
+    std::int32_t waited = this->wait_for(file_path_str);
+    if (1 != waited) {
+        if (0 == waited) {
+            WARN("%s was not preloaded", file_path_str);
+        }
+        this->load(file_path_str);
+    }
+
+    this->mutex.take(TIMEOUT_MAX);
+    std::shared_ptr<Recording> recording = this->recordings[file_path_str];
+    this->mutex.give();
+
+    return recording;
+}
+
+std::shared_ptr<PoseTrack> umbc::RecordingCache::get_pose_track(const char* file_path) {
+
+    string file_path_str = string(file_path);
+
+    std::int32_t waited = this->wait_for(file_path_str);
+    if (1 != waited) {
+        if (0 == waited) {
+            WARN("%s was not preloaded", file_path_str);
+        }
+        this->load(file_path_str);
+    }
+
+    this->mutex.take(TIMEOUT_MAX);
+    std::shared_ptr<PoseTrack> pose_track = this->pose_tracks[file_path_str];
+    this->mutex.give();
+
+    return pose_track;
+}
+
+void umbc::RecordingCache::remove(const char* file_path) {
+
+    this->mutex.take(TIMEOUT_MAX);
+    this->recordings.erase(string(file_path));
+    this->pose_tracks.erase(string(file_path));
+    this->mutex.give();
+}
+
+void umbc::RecordingCache::clear() {
+
+    this->mutex.take(TIMEOUT_MAX);
+    this->recordings.clear();
+    this->pose_tracks.clear();
+    this->mutex.give();
+}
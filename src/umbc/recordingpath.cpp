@@ -0,0 +1,336 @@
+/**
+ * \file umbc/recordingpath.cpp
+ *
+ * Contains the implementation of the RecordingPath. A RecordingPath turns a
+ * recorded run into squiggles motion profiles.
+ */
+
+#define LOG_MODULE LOG_MODULE_POSE
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cmath>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::RecordingPath::RecordingPath(double track_width_m, double max_velocity, double max_acceleration,
+    double max_jerk) {
+
+    this->track_width_m = track_width_m;
+    this->max_velocity = max_velocity;
+    this->max_acceleration = max_acceleration;
+    this->max_jerk = max_jerk;
+    this->drive = CORRECTION_ARCADE;
+    this->max_speed_mps = max_velocity;
+    this->max_turn_rate_rps = 2 * max_velocity / track_width_m;
+    this->segments = std::vector<std::vector<squiggles::Pose>>();
+    this->backwards = std::vector<std::uint8_t>();
+}
+
+void umbc::RecordingPath::reckon(Recording& recording, std::vector<squiggles::Pose>& poses) {
+
+    std::uint32_t number_of_frames = recording.size();
+    std::uint32_t number_of_events = recording.get_number_of_events();
+    std::uint32_t event = 0;
+    double x = 0;
+    double y = 0;
+    double theta = 0;
+
+    poses.clear();
+    poses.reserve(number_of_frames + 1);
+    poses.push_back(squiggles::Pose(x, y, theta));
+
+    for (std::uint32_t i = 0; i < number_of_frames; i++) {
+
+        if (event + 1 < number_of_events && i == recording.get_event_frame(event + 1)) {
+            event++;
+        }
+
+        std::uint32_t next_event = (event + 1 < number_of_events && i + 1 == recording.get_event_frame(event + 1))
+            ? event + 1 : event;
+        std::uint32_t next_time = (i + 1 < number_of_frames)
+            ? recording.get_time(i + 1, next_event) : recording.get_duration();
+        double dt = (next_time - recording.get_time(i, event)) / 1000.0;
+
+        const ControllerInput& controller_input = recording.get_event(event);
+        std::int32_t forward = controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_Y);
+        std::int32_t turn = 0;
+
+        switch (this->drive) {
+            case CORRECTION_SINGLE_ARCADE:
+                turn = controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_X);
+                break;
+            case CORRECTION_TANK:
+                forward = (controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_Y)
+                    + controller_input.get_analog(E_CONTROLLER_ANALOG_RIGHT_Y)) / 2;
+                turn = (controller_input.get_analog(E_CONTROLLER_ANALOG_LEFT_Y)
+                    - controller_input.get_analog(E_CONTROLLER_ANALOG_RIGHT_Y)) / 2;
+                break;
+            default:
+                turn = controller_input.get_analog(E_CONTROLLER_ANALOG_RIGHT_X);
+                break;
+        }
+
+        // +x is forward, +y is right and a positive turn is clockwise, the
+        // same as okapi's odometry
+        double velocity = this->max_speed_mps * forward / E_CONTROLLER_ANALOG_MAX;
+        double turn_rate = this->max_turn_rate_rps * turn / E_CONTROLLER_ANALOG_MAX;
+        double heading = theta + turn_rate * dt / 2;
+
+        x += velocity * std::cos(heading) * dt;
+        y += velocity * std::sin(heading) * dt;
+        theta += turn_rate * dt;
+        poses.push_back(squiggles::Pose(x, y, theta));
+    }
+}
+
+void umbc::RecordingPath::split(const std::vector<squiggles::Pose>& poses, double tolerance_m) {
+
+    std::vector<std::vector<squiggles::Pose>> runs;
+    std::vector<std::uint8_t> runs_backwards;
+    std::vector<squiggles::Pose> points;
+    std::uint8_t run_backwards = 0;
+    double previous_direction = 0;
+
+    this->segments.clear();
+    this->backwards.clear();
+
+    if (poses.empty()) {
+        return;
+    }
+
+    // space the poses out so odometry noise and turning in place do not
+    // look like motion, and start a new run at every cusp
+    points.push_back(poses[0]);
+    for (std::uint32_t i = 1; i < poses.size(); i++) {
+
+        const squiggles::Pose last = points.back();
+        if (waypoint_spacing_m > poses[i].dist(last)) {
+            continue;
+        }
+
+        double direction = std::atan2(poses[i].y - last.y, poses[i].x - last.x);
+        std::uint8_t is_backwards = 0 > std::cos(direction - poses[i].yaw);
+
+        if (1 < points.size() && (is_backwards != run_backwards
+            || max_bend_rad < std::fabs(std::remainder(direction - previous_direction, 2 * M_PI)))) {
+            runs.push_back(points);
+            runs_backwards.push_back(run_backwards);
+            points.clear();
+            points.push_back(last);
+        }
+
+        if (1 == points.size()) {
+            run_backwards = is_backwards;
+        }
+        points.push_back(poses[i]);
+        previous_direction = direction;
+    }
+    runs.push_back(points);
+    runs_backwards.push_back(run_backwards);
+
+    for (std::uint32_t i = 0; i < runs.size(); i++) {
+
+        std::vector<squiggles::Pose>& run = runs[i];
+        if (2 > run.size() || tolerance_m > run.front().dist(run.back())) {
+            continue;
+        }
+
+        // the profile follows the direction of travel, not the heading
+        std::vector<squiggles::Pose> waypoints = thin(run, tolerance_m);
+        for (std::uint32_t j = 0; j < waypoints.size(); j++) {
+            const squiggles::Pose& from = waypoints[(0 < j) ? j - 1 : j];
+            const squiggles::Pose& to = waypoints[(j + 1 < waypoints.size()) ? j + 1 : j];
+            waypoints[j].yaw = std::atan2(to.y - from.y, to.x - from.x);
+        }
+
+        this->segments.push_back(waypoints);
+        this->backwards.push_back(runs_backwards[i]);
+    }
+}
+
+std::vector<squiggles::Pose> umbc::RecordingPath::thin(const std::vector<squiggles::Pose>& points,
+    double tolerance_m) {
+
+    std::vector<std::uint8_t> keep(points.size(), 0);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;
+    std::vector<squiggles::Pose> kept;
+
+    keep.front() = 1;
+    keep.back() = 1;
+    ranges.push_back(std::make_pair(0, points.size() - 1));
+
+    // an explicit stack, a long run would overflow the task stack if this
+    // recursed
+    while (!ranges.empty()) {
+
+        std::uint32_t first = ranges.back().first;
+        std::uint32_t last = ranges.back().second;
+        ranges.pop_back();
+
+        const squiggles::Pose& a = points[first];
+        const squiggles::Pose& b = points[last];
+        double length = a.dist(b);
+        double furthest_distance = 0;
+        std::uint32_t furthest = first;
+
+        for (std::uint32_t i = first + 1; i < last; i++) {
+            double distance = (0 < length)
+                ? std::fabs((b.x - a.x) * (a.y - points[i].y) - (a.x - points[i].x) * (b.y - a.y)) / length
+                : a.dist(points[i]);
+            if (furthest_distance < distance) {
+                furthest_distance = distance;
+                furthest = i;
+            }
+        }
+
+        if (tolerance_m < furthest_distance) {
+            keep[furthest] = 1;
+            ranges.push_back(std::make_pair(first, furthest));
+            ranges.push_back(std::make_pair(furthest, last));
+        }
+    }
+
+    for (std::uint32_t i = 0; i < points.size(); i++) {
+        if (keep[i]) {
+            kept.push_back(points[i]);
+        }
+    }
+
+    return kept;
+}
+
+void umbc::RecordingPath::set_drive_model(correction_drive drive, double max_speed_mps, double max_turn_rate_rps) {
+
+    this->drive = drive;
+    this->max_speed_mps = max_speed_mps;
+    this->max_turn_rate_rps = max_turn_rate_rps;
+}
+
+std::uint32_t umbc::RecordingPath::fit(Recording& recording, PoseTrack* pose_track, double tolerance_m) {
+
+    std::vector<squiggles::Pose> poses;
+
+    if (nullptr != pose_track && 0 < pose_track->size()) {
+        poses.reserve(pose_track->size());
+        for (std::uint32_t i = 0; i < pose_track->size(); i++) {
+            okapi::OdomState state = pose_track->get_pose(i);
+            poses.push_back(squiggles::Pose(state.x.convert(okapi::meter), state.y.convert(okapi::meter),
+                state.theta.convert(okapi::radian)));
+        }
+    } else {
+        this->reckon(recording, poses);
+    }
+
+    this->split(poses, tolerance_m);
+
+    return this->segments.size();
+}
+
+std::uint32_t umbc::RecordingPath::size() {
+    return this->segments.size();
+}
+
+const std::vector<squiggles::Pose>& umbc::RecordingPath::get_waypoints(std::uint32_t segment) {
+    return this->segments[segment];
+}
+
+std::int32_t umbc::RecordingPath::is_backwards(std::uint32_t segment) {
+    return this->backwards[segment];
+}
+
+std::vector<squiggles::ProfilePoint> umbc::RecordingPath::generate(std::uint32_t segment) {
+
+    squiggles::Constraints constraints(this->max_velocity, this->max_acceleration, this->max_jerk);
+    squiggles::SplineGenerator generator(constraints,
+        std::make_shared<squiggles::TankModel>(this->track_width_m, constraints), profile_dt_s);
+
+    try {
+        return generator.generate(this->segments[segment]);
+    } catch (const std::exception& e) {
+        ERROR("failed to generate profile for segment %u: %s", segment, e.what());
+    }
+
+    return std::vector<squiggles::ProfilePoint>();
+}
+
+std::int32_t umbc::RecordingPath::save(const char* file_path, const std::vector<squiggles::ProfilePoint>& profile) {
+
+    string file_path_str = string(file_path);
+
+    std::ofstream file(file_path);
+    if (!file.good()) {
+        file.close();
+        ERROR("could not open %s", file_path_str);
+        return 0;
+    }
+
+    if (0 != squiggles::serialize_path(file, profile) || !file.good()) {
+        file.close();
+        ERROR("failed to write profile to %s", file_path_str);
+        return 0;
+    }
+    file.close();
+    INFO("%u profile points written to %s", profile.size(), file_path_str);
+
+    return 1;
+}
+
+std::int32_t umbc::RecordingPath::convert(const char* file_path, const char* directory, const char* path_id) {
+
+    string file_path_str = string(file_path);
+    string directory_str = string(directory);
+    string pose_track_path = PoseTrack::path_for(file_path_str);
+
+    Recording recording;
+    if (!recording.load(file_path)) {
+        return -1;
+    }
+
+    PoseTrack pose_track;
+    std::ifstream pose_track_file(pose_track_path, std::ifstream::binary);
+    std::int32_t has_pose_track = pose_track_file.good();
+    pose_track_file.close();
+
+    if (has_pose_track && pose_track.load(pose_track_path.c_str())) {
+        INFO("fitting waypoints to the pose track %s...", pose_track_path);
+        this->fit(recording, &pose_track);
+    } else {
+        INFO("no pose track for %s, dead reckoning from the drive sticks...", file_path_str);
+        this->fit(recording, nullptr);
+    }
+
+    if (0 == this->size()) {
+        WARN("the robot did not move in %s", file_path_str);
+        return 0;
+    }
+
+    if ('/' == directory_str.back()) {
+        directory_str.pop_back();
+    }
+
+    for (std::uint32_t i = 0; i < this->size(); i++) {
+
+        std::vector<squiggles::ProfilePoint> profile = this->generate(i);
+        string profile_path = directory_str + "/" + string(path_id) + "-" + std::to_string(i) + ".csv";
+
+        if (profile.empty() || !save(profile_path.c_str(), profile)) {
+            ERROR("failed to convert %s", file_path_str);
+            return -1;
+        }
+        INFO("segment %u has %u waypoints%s", i, this->segments[i].size(),
+            this->backwards[i] ? " and is driven backwards" : "");
+    }
+
+    return this->size();
+}
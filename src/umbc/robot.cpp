@@ -6,96 +6,28 @@
  * autonomous, training autonomous, and opcontrol.
  */
 
+#define LOG_MODULE LOG_MODULE_ROBOT
+
 #include "api.h"
 #include "umbc.h"
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 using namespace pros;
 using namespace umbc;
 using namespace std;
 
-std::int32_t umbc::Robot::menu_competition() {
-
-    std::uint8_t btn_press = 0;
-
-    pros::lcd::clear();
-    pros::lcd::set_text(1, "Select Competition Mode");
-    pros::lcd::set_text(3, "1) Match");
-    pros::lcd::set_text(4, "2) Skills");
-
-    INFO("waiting for competition mode selection...");
-    while(0 == btn_press) {
-
-        btn_press = pros::lcd::read_buttons();
-        
-        if (LCD_BTN_LEFT == btn_press) {
-            this->competition = COMPETITION_MATCH;
-            INFO("match selected for competition mode");
-        } else if (LCD_BTN_CENTER == btn_press) {
-            this->competition = COMPETITION_SKILLS;
-            INFO("skills selected for competition mode");
-        } else {
-            btn_press = 0;
-        }
-
-        pros::Task::delay(10);
-    }
-
-    while (0 != pros::lcd::read_buttons()) {
-        pros::Task::delay(10);
-    }
-
-    pros::lcd::clear();
-
-    return 1;
-}
-
-std::int32_t umbc::Robot::menu_mode() {
-
-    std::int32_t menu_direction = 1;
-    std::uint8_t btn_press = 0;
-
-    pros::lcd::clear();
-    pros::lcd::set_text(1, "Select Mode");
-    pros::lcd::set_text(3, "1) Competition");
-    pros::lcd::set_text(4, "2) Train Autonomous");
-    pros::lcd::set_text(5, "3) Back");
-    
-    INFO("waiting for mode selection...");
-    while(0 == btn_press) {
-
-        btn_press = pros::lcd::read_buttons();
-        
-        if (LCD_BTN_LEFT == btn_press) {
-            this->mode = MODE_COMPETITION;
-            INFO("competition selected for mode");
-        } else if (LCD_BTN_CENTER == btn_press) {
-            this->mode = MODE_TRAIN_AUTONOMOUS;
-            INFO("train autonomous selected for mode");
-        } else if (LCD_BTN_RIGHT == btn_press) {
-            menu_direction = -1;
-            INFO("going back to prevoius menu");
-        } else {
-            btn_press = 0;
-        }
-
-        pros::Task::delay(10);
-    }
-
-    while (0 != pros::lcd::read_buttons()) {
-        pros::Task::delay(10);
-    }
-
-    pros::lcd::clear();
-    return menu_direction;
-}
-
 umbc::Robot::Robot() {
 
     this->competition = COMPETITION_MATCH;
     this->mode = MODE_COMPETITION;
+    this->routine_slot = 0;
+}
+
+void umbc::Robot::set_odometry(okapi::Odometry* odometry) {
+    this->odometry = odometry;
 }
 
 void umbc::Robot::set_controllers_to_physical() {
@@ -116,29 +48,106 @@ umbc::mode umbc::Robot::get_mode() {
     return this->mode;
 }
 
+const char* umbc::Robot::get_routine_tag() {
+    return (COMPETITION_SKILLS == this->competition) ? this->skills_routine_tag : this->match_routine_tag;
+}
+
+void umbc::Robot::scan_routines() {
+    this->routine_catalog.scan(std::vector<std::string>{this->match_routine_tag, this->skills_routine_tag});
+}
+
+umbc::RoutineCatalog& umbc::Robot::get_routine_catalog() {
+    return this->routine_catalog;
+}
+
+void umbc::Robot::set_routine_slot(std::uint32_t slot) {
+    this->routine_slot = slot;
+}
+
+std::uint32_t umbc::Robot::get_routine_slot() {
+    return this->routine_slot;
+}
+
+void umbc::Robot::fill_routine_menu(umbc::Menu& menu) {
+
+    string tag = string(this->get_routine_tag());
+    std::uint32_t number_of_routines = 0;
+
+    menu.clear_items(MENU_ROUTINE);
+    for (std::uint32_t i = 0; i < this->routine_catalog.size(); i++) {
+        const Routine& routine = this->routine_catalog.get(i);
+        if (tag != routine.tag) {
+            continue;
+        }
+
+        std::uint32_t slot = routine.slot;
+        menu.add_item(MENU_ROUTINE, RoutineCatalog::describe(routine), MENU_DONE, [this, slot]() {
+            this->routine_slot = slot;
+            INFO("routine %u selected for autonomous", slot);
+        });
+        number_of_routines++;
+    }
+
+    if (0 == number_of_routines) {
+        menu.add_item(MENU_ROUTINE, "No Routines Found", MENU_BACK, [this, tag]() {
+            this->routine_slot = 0;
+            WARN("no %s routines found on the SD card", tag);
+        });
+    }
+    menu.add_item(MENU_ROUTINE, "Back", MENU_BACK, []() {
+        INFO("going back to previous menu");
+    });
+}
+
 void umbc::Robot::menu() {
 
-    uint8_t current_sub_menu = MENU_COMPETITION;
+    umbc::Menu menu;
+
+    if (!this->routine_catalog.is_scanned()) {
+        this->scan_routines();
+    }
 
-    if (!pros::lcd::is_initialized()) {
+    menu.set_screen(MENU_COMPETITION, "Select Competition Mode");
+    // a slot picked for one competition means nothing for the other
+    menu.add_item(MENU_COMPETITION, "Match", MENU_MODE, [this]() {
+        if (COMPETITION_MATCH != this->competition) {
+            this->routine_slot = 0;
+        }
+        this->competition = COMPETITION_MATCH;
+        INFO("match selected for competition mode");
+    });
+    menu.add_item(MENU_COMPETITION, "Skills", MENU_MODE, [this]() {
+        if (COMPETITION_SKILLS != this->competition) {
+            this->routine_slot = 0;
+        }
+        this->competition = COMPETITION_SKILLS;
+        INFO("skills selected for competition mode");
+    });
+
+    menu.set_screen(MENU_MODE, "Select Mode");
+    menu.add_item(MENU_MODE, "Competition", MENU_ROUTINE, [this, &menu]() {
+        this->mode = MODE_COMPETITION;
+        this->fill_routine_menu(menu);
+        INFO("competition selected for mode");
+    });
+    menu.add_item(MENU_MODE, "Train Autonomous", MENU_DONE, [this]() {
+        this->mode = MODE_TRAIN_AUTONOMOUS;
+        INFO("train autonomous selected for mode");
+    });
+    menu.add_item(MENU_MODE, "Back", MENU_BACK, []() {
+        INFO("going back to previous menu");
+    });
+
+    menu.set_screen(MENU_ROUTINE, "Select Routine");
+
+    DEBUG("waiting for menu selections...");
+    if (!menu.run(MENU_COMPETITION)) {
         ERROR("failed to initialize LCD menu");
         return;
     }
 
-    pros::lcd::clear();
-
-    while (MENU_MAX > current_sub_menu) {
-
-        switch (current_sub_menu) {
-            case MENU_COMPETITION:
-                current_sub_menu += menu_competition();
-            break;
-            case MENU_MODE:
-                current_sub_menu += menu_mode();
-            break;
-            default:
-                break;
-        }
+    if (MODE_COMPETITION == this->mode) {
+        this->preload_autonomous();
     }
 
     pros::lcd::clear();
@@ -148,6 +157,22 @@ void umbc::Robot::menu() {
     INFO("menu selections completed");
 }
 
+void umbc::Robot::preload_autonomous() {
+
+    string tag = string(this->get_routine_tag());
+
+    if (-1 == this->routine_catalog.find(tag, this->routine_slot)) {
+        WARN("no %s routine in slot %u to preload", tag, this->routine_slot);
+        return;
+    }
+
+    DEBUG("preloading autonomous input files...");
+    this->autonomous_cache.preload(
+        this->routine_catalog.path_for(tag, this->routine_slot, E_CONTROLLER_MASTER).c_str());
+    this->autonomous_cache.preload(
+        this->routine_catalog.path_for(tag, this->routine_slot, E_CONTROLLER_PARTNER).c_str());
+}
+
 void umbc::Robot::robot_opcontrol(Robot* robot) {
     robot->opcontrol();
 }
@@ -156,59 +181,75 @@ void umbc::Robot::autonomous(uint32_t include_partner_controller) {
 
     INFO("autonomous active");
 
-    INFO("setting robot controllers to virtual controllers...");
+    DEBUG("setting robot controllers to virtual controllers...");
 	this->set_controllers_to_virtual();
 	INFO("robot controllers set to virtual controllers");
 
-    if (COMPETITION_SKILLS == this->competition) {
-        INFO("loading skills input file for virtual master controller...");
-        this->vcontroller_master.load(this->skills_autonomous_file_master);
-        INFO("loaded " << skills_autonomous_file_master << " as input file for virtual master controller");
-        if (include_partner_controller) {
-            INFO("loading skills input file for virtual partner controller...");
-            vcontroller_partner.load(this->skills_autonomous_file_partner);
-            INFO("loaded " << skills_autonomous_file_partner << " as input file for virtual partner controller");
-        }
-    } else {
-        INFO("loading match input file for virtual master controller...");
-        this->vcontroller_master.load(this->match_autonomous_file_master);
-        INFO("loaded " << match_autonomous_file_master << " as input file for virtual master controller");
-        if (include_partner_controller) {
-            INFO("loading match input file for virtual partner controller...");
-            vcontroller_partner.load(this->match_autonomous_file_partner);
-            INFO("loaded " << match_autonomous_file_partner << " as input file for virtual partner controller");
+    string tag = string(this->get_routine_tag());
+    string autonomous_path_master = this->routine_catalog.path_for(tag, this->routine_slot, E_CONTROLLER_MASTER);
+    string autonomous_path_partner = this->routine_catalog.path_for(tag, this->routine_slot, E_CONTROLLER_PARTNER);
+    const char* autonomous_file_master = autonomous_path_master.c_str();
+    const char* autonomous_file_partner = autonomous_path_partner.c_str();
+
+    // a correction left from another routine must not steer this one
+    this->vcontroller_master.set_correction(nullptr);
+
+    DEBUG("loading input file for virtual master controller...");
+    this->vcontroller_master.load(this->autonomous_cache.get(autonomous_file_master));
+    INFO("loaded %s as input file for virtual master controller", autonomous_file_master);
+    if (nullptr != this->odometry) {
+        std::shared_ptr<PoseTrack> pose_track = this->autonomous_cache.get_pose_track(autonomous_file_master);
+        if (nullptr != pose_track.get()) {
+            std::shared_ptr<PoseCorrection> correction = std::make_shared<PoseCorrection>(this->odometry, pose_track);
+
+            // set here rather than by the playback task, before anything
+            // reads the odometry
+            correction->start(0);
+            this->vcontroller_master.set_correction(correction);
+            INFO("virtual master controller will correct drift from the recorded poses");
         }
     }
+    if (include_partner_controller) {
+        DEBUG("loading input file for virtual partner controller...");
+        vcontroller_partner.load(this->autonomous_cache.get(autonomous_file_partner));
+        INFO("loaded %s as input file for virtual partner controller", autonomous_file_partner);
+    }
 
-    INFO("starting opcontrol task...");
+    DEBUG("starting opcontrol task...");
     this->opcontrol_start();
     INFO("opcontrol task started");
 
-    INFO("starting task for virtual master controller...");
+    DEBUG("starting task for virtual master controller...");
     this->vcontroller_master.start();
     INFO("virtual master controller task started");
 
     if (include_partner_controller) {
-        INFO("starting task for virtual partner controller...");
+        DEBUG("starting task for virtual partner controller...");
         vcontroller_partner.start();
         INFO("virtual partner controller task started");
     }
 
-    INFO("waiting for virtual master controller input to complete...");
+    DEBUG("waiting for virtual master controller input to complete...");
     this->vcontroller_master.wait_till_complete();
     INFO("virtual master controller input completed");
 
     if (include_partner_controller) {
-        INFO("waiting for virtual partner controller input to complete...");
+        DEBUG("waiting for virtual partner controller input to complete...");
         vcontroller_partner.wait_till_complete();
         INFO("virtual partner controller input completed");
     }
 
-    INFO("terminating opcontrol task...");
+    DEBUG("terminating opcontrol task...");
     this->opcontrol_stop();
     INFO("opcontrol task has been terminated");
 
-    INFO("setting robot controllers to physical controllers...");
+    this->opcontrol_timing.print();
+    this->vcontroller_master.get_loop_timing().print();
+    if (include_partner_controller) {
+        vcontroller_partner.get_loop_timing().print();
+    }
+
+    DEBUG("setting robot controllers to physical controllers...");
     this->set_controllers_to_physical();
 	INFO("robot controllers set to physical controllers");
 
@@ -219,73 +260,104 @@ void umbc::Robot::train_autonomous(uint32_t record_partner_controller) {
 
     INFO("autonomous training active");
 
-    ControllerRecorder controller_recorder_master = ControllerRecorder(controller_master, opcontrol_delay_ms);
-    ControllerRecorder controller_recorder_partner = ControllerRecorder(controller_partner, opcontrol_delay_ms);
+    ControllerRecorder controller_recorder_master = ControllerRecorder(controller_master, record_poll_rate_ms,
+        E_CONTROLLER_MASTER, INPUT_ENCODING_RLE, INPUT_FLAG_TIMESTAMPS, analog_deadband);
+    ControllerRecorder controller_recorder_partner = ControllerRecorder(controller_partner, record_poll_rate_ms,
+        E_CONTROLLER_PARTNER, INPUT_ENCODING_RLE, INPUT_FLAG_TIMESTAMPS, analog_deadband);
+
+    string tag = string(this->get_routine_tag());
+
+    if (!this->routine_catalog.is_scanned()) {
+        this->scan_routines();
+    }
 
-    INFO("starting opcontrol task...");
+    std::int32_t slot = this->routine_catalog.next_slot(tag);
+    if (0 > slot) {
+        ERROR("every %s routine slot is taken, autonomous training cancelled", tag);
+        return;
+    }
+
+    string autonomous_path_master = this->routine_catalog.path_for(tag, slot, E_CONTROLLER_MASTER);
+    string autonomous_path_partner = this->routine_catalog.path_for(tag, slot, E_CONTROLLER_PARTNER);
+    const char* autonomous_file_master = autonomous_path_master.c_str();
+    const char* autonomous_file_partner = autonomous_path_partner.c_str();
+
+    DEBUG("starting opcontrol task...");
     this->opcontrol_start();
     INFO("opcontrol task started");
 
-    INFO("starting master controller recording...");
-    controller_recorder_master.start();
-    INFO("recording master controller has begun");
+    controller_recorder_master.set_odometry(this->odometry, (COMPETITION_SKILLS == this->competition)
+        ? this->skills_autonomous_time_ms : this->match_autonomous_time_ms);
+
+    DEBUG("starting master controller recording...");
+    controller_recorder_master.start(autonomous_file_master);
+    INFO("recording master controller to %s has begun", autonomous_file_master);
     if (record_partner_controller) {
-        INFO("starting partner controller recording...");
-        controller_recorder_partner.start();
-        INFO("recording partner controller has begun");
+        DEBUG("starting partner controller recording...");
+        controller_recorder_partner.start(autonomous_file_partner);
+        INFO("recording partner controller to %s has begun", autonomous_file_partner);
     }
 
     if (COMPETITION_SKILLS == this->competition) {
-        INFO("setting task delay for skills autonomous time...");
+        DEBUG("setting task delay for skills autonomous time...");
         pros::Task::delay(this->skills_autonomous_time_ms);
-        INFO("task delay set to " << this->skills_autonomous_time_ms << " ms");
+        INFO("task delay set to %u ms", this->skills_autonomous_time_ms);
     } else {
-        INFO("setting task delay for match autonomous time...");
+        DEBUG("setting task delay for match autonomous time...");
         pros::Task::delay(this->match_autonomous_time_ms);
-        INFO("task delay set to " << this->match_autonomous_time_ms << " ms");
+        INFO("task delay set to %u ms", this->match_autonomous_time_ms);
     }
 
-    INFO("terminating opcontrol task...");
+    DEBUG("terminating opcontrol task...");
     this->opcontrol_stop();
     INFO("opcontrol task has been terminated");
+    this->opcontrol_timing.print();
 
-    INFO("stopping master controller recording...");
+    DEBUG("stopping master controller recording...");
     controller_recorder_master.stop();
     INFO("master controller recording stopped");
 
     if (record_partner_controller) {
-        INFO("stopping partner controller recording...");
+        DEBUG("stopping partner controller recording...");
         controller_recorder_partner.stop();
         INFO("partner controller recording stopped");
     }
 
-    INFO("saving master controller file...");
-    if (COMPETITION_SKILLS == this->competition) {
-        controller_recorder_master.save(this->skills_autonomous_file_master);
-        INFO("master controller file saved to " << this->skills_autonomous_file_master);
-        if (record_partner_controller) {
-            INFO("saving partner controller file...");
-            controller_recorder_partner.save(this->skills_autonomous_file_partner);
-            INFO("partner controller file saved to " << this->skills_autonomous_file_partner);
-        }
-    } else {
-        controller_recorder_master.save(this->match_autonomous_file_master);
-        INFO("master controller file saved to " << this->match_autonomous_file_master);
-        if (record_partner_controller) {
-            INFO("saving partner controller file...");
-            controller_recorder_partner.save(this->match_autonomous_file_partner);
-            INFO("partner controller file saved to " << this->match_autonomous_file_partner);
-        }
+    DEBUG("saving master controller file...");
+    controller_recorder_master.save(autonomous_file_master);
+    this->autonomous_cache.remove(autonomous_file_master);
+    INFO("master controller file saved to %s", autonomous_file_master);
+    if (record_partner_controller) {
+        DEBUG("saving partner controller file...");
+        controller_recorder_partner.save(autonomous_file_partner);
+        this->autonomous_cache.remove(autonomous_file_partner);
+        INFO("partner controller file saved to %s", autonomous_file_partner);
     }
 
+    this->routine_catalog.update(tag, slot);
+    this->routine_slot = slot;
+    INFO("routine %u selected for autonomous", slot);
+
     INFO("autonomous training complete");
 }
 
+void umbc::Robot::opcontrol_begin() {
+    this->opcontrol_timing.begin();
+}
+
+void umbc::Robot::opcontrol_tick() {
+
+    this->opcontrol_timing.end();
+    this->vcontroller_master.tick();
+    this->vcontroller_partner.tick();
+}
+
 void umbc::Robot::opcontrol_start() {
 
+    this->opcontrol_timing.reset();
     this->t_opcontrol.reset(
         new Task((task_fn_t)this->robot_opcontrol, (void*)this, this->t_opcontrol_name));
-    INFO(string(t_opcontrol_name) + " has started");
+    DEBUG("%s has started", t_opcontrol_name);
 }
 
 void umbc::Robot::opcontrol_pause() {
@@ -295,10 +367,10 @@ void umbc::Robot::opcontrol_pause() {
     if (nullptr != t_opcontrol) {
         try {
             t_opcontrol->suspend();
-            INFO(string(t_opcontrol_name) + " is paused");
+            DEBUG("%s is paused", t_opcontrol_name);
         }
         catch (...) {
-            ERROR("failed to suspend " + string(t_opcontrol_name));
+            ERROR("failed to suspend %s", t_opcontrol_name);
         }
     }
 }
@@ -310,9 +382,9 @@ void umbc::Robot::opcontrol_resume() {
     if (nullptr != t_opcontrol) {
         try {
             t_opcontrol->resume();
-            INFO(string(t_opcontrol_name) + " has resumed");
+            DEBUG("%s has resumed", t_opcontrol_name);
         } catch (...) {
-            ERROR("failed to resume " +  string(t_opcontrol_name));
+            ERROR("failed to resume %s", t_opcontrol_name);
         }
     }
 }
@@ -324,9 +396,9 @@ void umbc::Robot::opcontrol_stop() {
     if (nullptr != t_opcontrol) {
         try {
             t_opcontrol->remove();
-            INFO(string(t_opcontrol_name) + " is stopped");
+            DEBUG("%s is stopped", t_opcontrol_name);
         } catch (...) {
-            ERROR("failed to stop " + string(t_opcontrol_name));
+            ERROR("failed to stop %s", t_opcontrol_name);
         }
     }
 }
@@ -337,4 +409,24 @@ std::int32_t umbc::Robot::opcontrol_isListed() {
 
     return (nullptr == t_opcontrol) ? 0 
         : ((t_opcontrol->get_state() != E_TASK_STATE_INVALID) && (t_opcontrol->get_state() != E_TASK_STATE_DELETED));
+}
+
+umbc::LoopTiming& umbc::Robot::get_opcontrol_timing() {
+    return this->opcontrol_timing;
+}
+
+umbc::Controller* umbc::Robot::get_controller_master() {
+    return this->controller_master;
+}
+
+umbc::Controller* umbc::Robot::get_controller_partner() {
+    return this->controller_partner;
+}
+
+umbc::VController* umbc::Robot::get_vcontroller_master() {
+    return &this->vcontroller_master;
+}
+
+umbc::VController* umbc::Robot::get_vcontroller_partner() {
+    return &this->vcontroller_partner;
 }
\ No newline at end of file
@@ -0,0 +1,199 @@
+/**
+ * \file umbc/routinecatalog.cpp
+ *
+ * Contains the implementation of the RoutineCatalog. The RoutineCatalog
+ * indexes the autonomous routines saved on the SD card by probing their
+ * slots and reading only the header of each file.
+ */
+
+#define LOG_MODULE LOG_MODULE_RECORDING
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+umbc::RoutineCatalog::RoutineCatalog(const char* directory) {
+
+    this->directory = string(directory);
+    if (!this->directory.empty() && '/' == this->directory.back()) {
+        this->directory.pop_back();
+    }
+    this->routines = std::vector<Routine>();
+    this->scanned = 0;
+}
+
+std::string umbc::RoutineCatalog::path_for(const std::string& tag, std::uint32_t slot,
+    controller_id_e_t controller_id) {
+
+    string file_path = this->directory + "/autonomous_" + tag;
+
+    if (0 < slot) {
+        file_path += "_" + std::to_string(slot);
+    }
+    if (E_CONTROLLER_PARTNER == controller_id) {
+        file_path += "-partner";
+    }
+
+    return file_path + ".bin";
+}
+
+std::int32_t umbc::RoutineCatalog::probe(const std::string& tag, std::uint32_t slot, Routine* routine) {
+
+    std::uint8_t header[InputEncoder::header_size];
+    string file_path = this->path_for(tag, slot, E_CONTROLLER_MASTER);
+
+    std::ifstream file(file_path, std::ifstream::binary);
+    if (!file.good()) {
+        return 0;
+    }
+
+    // only the header, the body is read when the routine is played
+    file.read((char*)header, sizeof(header));
+    std::streamsize size = file.gcount();
+    file.close();
+
+    routine->tag = tag;
+    routine->slot = slot;
+    routine->file_path = file_path;
+    routine->poll_rate_ms = 0;
+    routine->controller_id = E_CONTROLLER_MASTER;
+    routine->duration_ms = 0;
+
+    if (!Playlist::is_playlist(header, size)) {
+        InputDecoder decoder(header, size);
+        if (0 == decoder.peek_header(routine->poll_rate_ms)) {
+            WARN("skipping %s, it is not a controller input file", file_path);
+            return 0;
+        }
+        routine->controller_id = decoder.get_controller_id();
+        routine->duration_ms = decoder.get_number_of_frames() * routine->poll_rate_ms;
+    }
+
+    std::ifstream partner_file(this->path_for(tag, slot, E_CONTROLLER_PARTNER), std::ifstream::binary);
+    routine->has_partner = partner_file.good();
+    partner_file.close();
+
+    return 1;
+}
+
+std::uint32_t umbc::RoutineCatalog::scan(const std::vector<std::string>& tags) {
+
+    Routine routine;
+
+    this->routines.clear();
+
+    INFO("scanning %s for autonomous routines...", this->directory);
+    for (const std::string& tag : tags) {
+        for (std::uint32_t slot = 0; slot < max_slots; slot++) {
+            if (this->probe(tag, slot, &routine)) {
+                this->routines.push_back(routine);
+            }
+        }
+    }
+    this->scanned = 1;
+    INFO("found %u autonomous routines", this->routines.size());
+
+    return this->routines.size();
+}
+
+std::int32_t umbc::RoutineCatalog::is_scanned() {
+    return this->scanned;
+}
+
+std::int32_t umbc::RoutineCatalog::update(const std::string& tag, std::uint32_t slot) {
+
+    Routine routine;
+    std::int32_t index = this->find(tag, slot);
+    std::int32_t found = (max_slots > slot) && this->probe(tag, slot, &routine);
+
+    if (0 <= index) {
+        if (found) {
+            this->routines[index] = routine;
+        } else {
+            this->routines.erase(this->routines.begin() + index);
+        }
+        return found;
+    }
+
+    if (!found) {
+        return 0;
+    }
+
+    // after the last routine with the same tag and a lower slot, otherwise
+    // after every other tag, so the tag order of scan is kept
+    std::vector<Routine>::iterator position = this->routines.end();
+    for (std::vector<Routine>::iterator it = this->routines.begin(); it != this->routines.end(); it++) {
+        if (it->tag == tag && it->slot > slot) {
+            position = it;
+            break;
+        }
+        if (it->tag == tag) {
+            position = it + 1;
+        }
+    }
+    this->routines.insert(position, routine);
+
+    return 1;
+}
+
+std::int32_t umbc::RoutineCatalog::next_slot(const std::string& tag) {
+
+    for (std::uint32_t slot = 0; slot < max_slots; slot++) {
+        if (0 <= this->find(tag, slot)) {
+            continue;
+        }
+
+        // a file that is not indexed may still not be ours to overwrite,
+        // and a partner file left alone would be played with a new master
+        std::ifstream file(this->path_for(tag, slot, E_CONTROLLER_MASTER), std::ifstream::binary);
+        std::ifstream partner_file(this->path_for(tag, slot, E_CONTROLLER_PARTNER), std::ifstream::binary);
+        if (!file.good() && !partner_file.good()) {
+            return slot;
+        }
+        file.close();
+        partner_file.close();
+    }
+
+    return -1;
+}
+
+std::int32_t umbc::RoutineCatalog::find(const std::string& tag, std::uint32_t slot) {
+
+    for (std::uint32_t i = 0; i < this->routines.size(); i++) {
+        if (this->routines[i].tag == tag && this->routines[i].slot == slot) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+std::uint32_t umbc::RoutineCatalog::size() {
+    return this->routines.size();
+}
+
+const Routine& umbc::RoutineCatalog::get(std::uint32_t index) {
+    return this->routines[index];
+}
+
+std::string umbc::RoutineCatalog::describe(const Routine& routine) {
+
+    char duration[16] = "?";
+
+    if (0 < routine.duration_ms) {
+        std::snprintf(duration, sizeof(duration), "%u.%us", routine.duration_ms / 1000,
+            (routine.duration_ms % 1000) / 100);
+    }
+
+    return routine.tag + " " + std::to_string(routine.slot) + "  " + string(duration)
+        + (routine.has_partner ? " P" : "");
+}
@@ -0,0 +1,355 @@
+/**
+ * \file umbc/telemetry.cpp
+ *
+ * Contains the implementation of the Telemetry. The Telemetry samples the
+ * state of a Robot at a fixed rate and sends it as COBS framed binary
+ * packets.
+ */
+
+#define LOG_MODULE LOG_MODULE_TELEMETRY
+
+#include "api.h"
+#include "umbc.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+using namespace pros;
+using namespace umbc;
+using namespace std;
+
+static void put_u16(std::uint8_t* buffer, std::uint16_t value) {
+    buffer[0] = value & 0xFF;
+    buffer[1] = (value >> 8) & 0xFF;
+}
+
+static void put_u32(std::uint8_t* buffer, std::uint32_t value) {
+    for (std::uint32_t i = 0; i < 4; i++) {
+        buffer[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+static std::uint16_t get_u16(const std::uint8_t* buffer) {
+    return (std::uint16_t)buffer[0] | ((std::uint16_t)buffer[1] << 8);
+}
+
+static std::uint32_t get_u32(const std::uint8_t* buffer) {
+
+    std::uint32_t value = 0;
+    for (std::uint32_t i = 0; i < 4; i++) {
+        value |= (std::uint32_t)buffer[i] << (8 * i);
+    }
+    return value;
+}
+
+static std::uint32_t put_controller_input(std::uint8_t* buffer, const ControllerInput& controller_input) {
+
+    put_u16(buffer, controller_input.buttons());
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        buffer[2 + i] = controller_input.axes()[i];
+    }
+    return 2 + ControllerInput::number_of_analogs;
+}
+
+static std::uint32_t get_controller_input(const std::uint8_t* buffer, ControllerInput* controller_input) {
+
+    std::int8_t axes[ControllerInput::number_of_analogs];
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        axes[i] = buffer[2 + i];
+    }
+    controller_input->set_all(get_u16(buffer), axes);
+    return 2 + ControllerInput::number_of_analogs;
+}
+
+umbc::Telemetry::Telemetry(Robot* robot, std::uint8_t channels, std::uint32_t period_ms) {
+
+    this->robot = robot;
+    this->channels = channels & TELEMETRY_CHANNEL_ALL;
+    this->period_ms = (0 < period_ms) ? period_ms : 1;
+    this->sequence = 0;
+    this->stream = nullptr;
+    this->serial.reset(nullptr);
+    this->packets = 0;
+    this->failures = 0;
+    this->t_telemetry.reset(nullptr);
+}
+
+void umbc::Telemetry::send_packets(void* Telemetry) {
+
+    umbc::Telemetry* telemetry = (umbc::Telemetry*)Telemetry;
+    std::uint32_t now = pros::millis();
+
+    while (1) {
+        telemetry->send();
+        pros::Task::delay_until(&now, telemetry->period_ms);
+    }
+}
+
+void umbc::Telemetry::start_task() {
+
+    if (nullptr != this->t_telemetry) {
+        return;
+    }
+
+    try {
+        this->t_telemetry.reset(new Task((task_fn_t)this->send_packets, (void*)this, TASK_PRIORITY_DEFAULT - 1,
+            TASK_STACK_DEPTH_DEFAULT, this->t_telemetry_name));
+        DEBUG("%s has started", t_telemetry_name);
+    } catch (...) {
+        ERROR("failed to start %s", t_telemetry_name);
+    }
+}
+
+void umbc::Telemetry::set_channels(std::uint8_t channels) {
+    this->channels = channels & TELEMETRY_CHANNEL_ALL;
+}
+
+void umbc::Telemetry::set_period(std::uint32_t period_ms) {
+    this->period_ms = (0 < period_ms) ? period_ms : 1;
+}
+
+std::uint32_t umbc::Telemetry::pack(std::uint8_t* packet) {
+
+    std::uint8_t channels = this->channels;
+    std::uint32_t size = header_size;
+
+    packet[0] = packet_version;
+    packet[1] = channels;
+    put_u16(&packet[2], this->sequence++);
+    put_u32(&packet[4], pros::millis());
+
+    if (channels & TELEMETRY_CHANNEL_CONTROLLER) {
+        size += put_controller_input(&packet[size], this->robot->get_controller_master()->snapshot());
+        size += put_controller_input(&packet[size], this->robot->get_controller_partner()->snapshot());
+    }
+
+    if (channels & TELEMETRY_CHANNEL_MODE) {
+        packet[size++] = this->robot->get_competition();
+        packet[size++] = this->robot->get_mode();
+        packet[size++] = pros::competition::get_status();
+    }
+
+    if (channels & TELEMETRY_CHANNEL_PLAYBACK) {
+        VController* vcontroller_master = this->robot->get_vcontroller_master();
+        VController* vcontroller_partner = this->robot->get_vcontroller_partner();
+
+        packet[size++] = (this->robot->get_controller_master() == vcontroller_master)
+            | ((this->robot->get_controller_partner() == vcontroller_partner) << 1);
+        put_u32(&packet[size], vcontroller_master->get_position());
+        put_u32(&packet[size + 4], vcontroller_partner->get_position());
+        size += 8;
+    }
+
+    if (channels & TELEMETRY_CHANNEL_LOOP_TIMING) {
+        LoopTiming& loop_timing = this->robot->get_opcontrol_timing();
+
+        put_u32(&packet[size], loop_timing.get_iterations());
+        put_u32(&packet[size + 4], loop_timing.get_overruns());
+        put_u32(&packet[size + 8], loop_timing.get_max_lateness_us());
+        put_u32(&packet[size + 12], loop_timing.get_max_duration_us());
+        size += 16;
+    }
+
+    put_u16(&packet[size], crc16(packet, size));
+    return size + crc_size;
+}
+
+std::int32_t umbc::Telemetry::send() {
+
+    std::uint8_t packet[max_packet_size];
+    std::uint8_t frame[max_frame_size];
+    std::int32_t written = 0;
+
+    if (nullptr == this->stream && nullptr == this->serial) {
+        return 0;
+    }
+
+    std::uint32_t frame_size = encode(packet, this->pack(packet), frame);
+
+    if (nullptr != this->serial) {
+        written = this->serial->write(frame, frame_size);
+    } else {
+        written = std::fwrite(frame, 1, frame_size, this->stream);
+        std::fflush(this->stream);
+    }
+
+    this->packets++;
+    if (written != (std::int32_t)frame_size) {
+        this->failures++;
+        return 0;
+    }
+
+    return 1;
+}
+
+void umbc::Telemetry::start(FILE* stream) {
+
+    this->serial.reset(nullptr);
+    this->stream = stream;
+    this->start_task();
+    INFO("sending telemetry every %ums", this->period_ms);
+}
+
+void umbc::Telemetry::start(std::uint8_t port, std::int32_t baudrate) {
+
+    try {
+        this->serial.reset(new pros::Serial(port, baudrate));
+    } catch (...) {
+        this->serial.reset(nullptr);
+        ERROR("could not open a serial device on port %u", port);
+        return;
+    }
+
+    this->stream = nullptr;
+    this->start_task();
+    INFO("sending telemetry to port %u every %ums", port, this->period_ms);
+}
+
+void umbc::Telemetry::stop() {
+
+    Task* t_telemetry = this->t_telemetry.get();
+
+    if (nullptr != t_telemetry) {
+        try {
+            t_telemetry->remove();
+            DEBUG("%s is stopped", t_telemetry_name);
+        } catch (...) {
+            ERROR("failed to stop %s", t_telemetry_name);
+        }
+    }
+    this->t_telemetry.reset(nullptr);
+}
+
+std::uint32_t umbc::Telemetry::get_packets() {
+    return this->packets;
+}
+
+std::uint32_t umbc::Telemetry::get_failures() {
+    return this->failures;
+}
+
+std::uint16_t umbc::Telemetry::crc16(const std::uint8_t* data, std::uint32_t size) {
+
+    std::uint16_t crc = 0xFFFF;
+
+    for (std::uint32_t i = 0; i < size; i++) {
+        crc ^= (std::uint16_t)data[i] << 8;
+        for (std::uint32_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+
+    return crc;
+}
+
+std::uint32_t umbc::Telemetry::encode(const std::uint8_t* packet, std::uint32_t size, std::uint8_t* frame) {
+
+    std::uint32_t code_index = 0;
+    std::uint32_t frame_size = 1;
+    std::uint8_t code = 1;
+
+    // each code byte is the distance to the next 0, or 0xFF for a run of
+    // 254 bytes without one
+    for (std::uint32_t i = 0; i < size; i++) {
+        if (0 != packet[i]) {
+            frame[frame_size++] = packet[i];
+            code++;
+        }
+        if (0 == packet[i] || 0xFF == code) {
+            frame[code_index] = code;
+            code_index = frame_size++;
+            code = 1;
+        }
+    }
+
+    frame[code_index] = code;
+    frame[frame_size++] = 0;
+
+    return frame_size;
+}
+
+std::int32_t umbc::Telemetry::decode(const std::uint8_t* frame, std::uint32_t size, std::uint8_t* packet) {
+
+    std::uint32_t packet_size = 0;
+    std::uint32_t i = 0;
+
+    while (i < size) {
+        std::uint8_t code = frame[i++];
+
+        if (0 == code || i + code - 1 > size) {
+            return -1;
+        }
+
+        for (std::uint32_t j = 1; j < code; j++) {
+            if (0 == frame[i]) {
+                return -1;
+            }
+            packet[packet_size++] = frame[i++];
+        }
+
+        if (0xFF != code && i < size) {
+            packet[packet_size++] = 0;
+        }
+    }
+
+    return packet_size;
+}
+
+std::int32_t umbc::Telemetry::parse(const std::uint8_t* packet, std::uint32_t size,
+    TelemetryPacket* telemetry_packet) {
+
+    *telemetry_packet = TelemetryPacket();
+
+    if (header_size + crc_size > size || packet_version != packet[0]
+        || get_u16(&packet[size - crc_size]) != crc16(packet, size - crc_size)) {
+        return 0;
+    }
+
+    std::uint8_t channels = packet[1];
+    std::uint32_t expected = header_size + crc_size;
+
+    expected += (channels & TELEMETRY_CHANNEL_CONTROLLER) ? 2 * (2 + ControllerInput::number_of_analogs) : 0;
+    expected += (channels & TELEMETRY_CHANNEL_MODE) ? 3 : 0;
+    expected += (channels & TELEMETRY_CHANNEL_PLAYBACK) ? 9 : 0;
+    expected += (channels & TELEMETRY_CHANNEL_LOOP_TIMING) ? 16 : 0;
+    if (expected != size) {
+        return 0;
+    }
+
+    std::uint32_t offset = header_size;
+
+    telemetry_packet->version = packet[0];
+    telemetry_packet->channels = channels;
+    telemetry_packet->sequence = get_u16(&packet[2]);
+    telemetry_packet->time_ms = get_u32(&packet[4]);
+
+    if (channels & TELEMETRY_CHANNEL_CONTROLLER) {
+        offset += get_controller_input(&packet[offset], &telemetry_packet->controller_master);
+        offset += get_controller_input(&packet[offset], &telemetry_packet->controller_partner);
+    }
+
+    if (channels & TELEMETRY_CHANNEL_MODE) {
+        telemetry_packet->competition = packet[offset];
+        telemetry_packet->mode = packet[offset + 1];
+        telemetry_packet->competition_status = packet[offset + 2];
+        offset += 3;
+    }
+
+    if (channels & TELEMETRY_CHANNEL_PLAYBACK) {
+        telemetry_packet->playback_flags = packet[offset];
+        telemetry_packet->position_master_ms = get_u32(&packet[offset + 1]);
+        telemetry_packet->position_partner_ms = get_u32(&packet[offset + 5]);
+        offset += 9;
+    }
+
+    if (channels & TELEMETRY_CHANNEL_LOOP_TIMING) {
+        telemetry_packet->iterations = get_u32(&packet[offset]);
+        telemetry_packet->overruns = get_u32(&packet[offset + 4]);
+        telemetry_packet->max_lateness_us = get_u32(&packet[offset + 8]);
+        telemetry_packet->max_duration_us = get_u32(&packet[offset + 12]);
+        offset += 16;
+    }
+
+    return 1;
+}
@@ -6,70 +6,269 @@
  * file of controller inputs.
  */
 
+#define LOG_MODULE LOG_MODULE_PLAYBACK
+
 #include "api.h"
 #include "umbc.h"
 
-#include <fstream>
-#include <map>
+#include <memory>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 using namespace pros;
 using namespace umbc;
 using namespace std;
 
-umbc::VController::VController() {
-
-    this->poll_rate_ms = 0;
-    this->controller_input = std::queue<ControllerInput>();
+umbc::VController::VController(std::uint16_t poll_rate_ms) {
+
+    this->recording = std::make_shared<Recording>();
+    this->controller_input_index = 0;
+    this->controller_input_event = 0;
+    this->controller_input.store(ControllerInput());
+    this->poll_rate_ms = poll_rate_ms;
+    this->position_ms = 0;
+    this->seek_ms = -1;
+    this->speed = 1;
+    this->loop_ms = 0;
+    this->resumed = 0;
+    this->policy = PLAYBACK_WALL_CLOCK;
+    this->max_lead = 1;
+    this->ticks = 0;
+    this->steps = 0;
+    this->correction = nullptr;
     this->t_update_controller_input.reset(nullptr);
-
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_L1, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_L2, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_R1, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_R2, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_UP, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_DOWN, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_LEFT, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_RIGHT, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_X, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_B, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_Y, Digital()));
-    this->digitals.insert(std::pair<controller_digital_e_t, Digital>(E_CONTROLLER_DIGITAL_A, Digital()));  
 }
 
 void umbc::VController::update(void* vcontroller) {
 
     umbc::VController* controller = (umbc::VController*)vcontroller;
+    std::shared_ptr<Recording> recording = controller->recording;
+    std::uint32_t number_of_frames = recording->size();
+    std::uint32_t number_of_events = recording->get_number_of_events();
+    std::uint16_t poll_rate_ms = recording->get_poll_rate();
+    std::shared_ptr<PoseCorrection> correction = controller->correction;
 
-    if (0 == controller->poll_rate_ms) {
+    if (0 == poll_rate_ms) {
         ERROR("invalid poll rate");
         return;
     }
 
     std::uint32_t now = pros::millis();
+    float position_ms = controller->position_ms;
+    float delay_remainder_ms = 0;
+
+    ControllerInput controller_input = controller->controller_input.load();
+
+    while (controller->controller_input_index < number_of_frames) {
+
+        float speed = controller->speed;
+
+        if (0 != controller->poll_rate_ms) {
+            controller->wait_for_step(&now, controller->poll_rate_ms);
+            controller->loop_timing.begin();
+            position_ms += controller->poll_rate_ms * speed;
+        } else {
+            std::uint32_t index = controller->controller_input_index;
+            std::uint32_t event = controller->controller_input_event;
+            std::uint32_t next = index + 1;
+            std::uint32_t next_event = event;
+
+            if (event + 1 < number_of_events && next == recording->get_event_frame(event + 1)) {
+                next_event++;
+            }
+
+            // follow the recorded timeline rather than the poll rate
+            std::uint32_t next_time = (next < number_of_frames)
+                ? recording->get_time(next, next_event) : recording->get_duration();
+            float delay_ms = (next_time - recording->get_time(index, event)) / speed + delay_remainder_ms;
+            delay_remainder_ms = delay_ms - (std::uint32_t)delay_ms;
+            controller->wait_for_step(&now, delay_ms);
+            controller->loop_timing.begin();
+            controller_input = (next < number_of_frames) ? recording->get_event(next_event) : ControllerInput();
+            controller->controller_input_event = next_event;
+            controller->controller_input_index = next;
+            position_ms = next_time;
+        }
+
+        if (controller->resumed.exchange(0)) {
+            // do not play back the time spent paused all at once
+            now = pros::millis();
+        }
+
+        std::int32_t seek_ms = controller->seek_ms.exchange(-1);
+        std::uint64_t loop_ms = controller->loop_ms;
+        std::uint32_t loop_start_ms = loop_ms >> 32;
+        std::uint32_t loop_end_ms = loop_ms & UINT32_MAX;
+
+        if (0 <= seek_ms) {
+            position_ms = seek_ms;
+            controller_input = controller->jump(position_ms);
+        } else if (loop_start_ms < loop_end_ms && loop_end_ms <= position_ms) {
+            position_ms = loop_start_ms;
+            controller_input = controller->jump(position_ms);
+        }
+
+        if (0 != controller->poll_rate_ms && controller->controller_input_index < number_of_frames) {
+            controller->resample(position_ms, controller_input);
+        }
+        controller->position_ms = position_ms;
+
+        // the recorded frame is kept as is, the correction is only published
+        ControllerInput published = controller_input;
+        if (nullptr != correction.get() && controller->controller_input_index < number_of_frames) {
+            correction->correct(controller->controller_input_index, published);
+        }
+
+        // publish the whole frame at once, the getters are called from other
+        // tasks and must never see part of an update
+        controller->controller_input.store(published);
+        if (controller->controller_input_index < number_of_frames) {
+            controller->digital_edges.update(published.buttons());
+        }
+        controller->loop_timing.end();
+    }
+
+    controller->digital_edges.reset();
+}
+
+void umbc::VController::wait_for_step(std::uint32_t* now, std::uint32_t delay_ms) {
+
+    this->steps++;
+
+    switch (this->policy) {
+        case PLAYBACK_LOCKSTEP:
+            while (PLAYBACK_LOCKSTEP == this->policy && (std::int32_t)(this->steps - this->ticks) > 0) {
+                pros::Task::notify_take(true, TIMEOUT_MAX);
+            }
+            *now = pros::millis();
+            break;
+        case PLAYBACK_CATCH_UP:
+            pros::Task::delay_until(now, delay_ms);
+            if ((std::int32_t)(this->steps - this->ticks) > (std::int32_t)this->max_lead) {
+                while (PLAYBACK_CATCH_UP == this->policy
+                    && (std::int32_t)(this->steps - this->ticks) > (std::int32_t)this->max_lead) {
+                    pros::Task::notify_take(true, TIMEOUT_MAX);
+                }
+                // drop the time spent waiting for the reader from the timeline
+                *now = pros::millis();
+            }
+            break;
+        default:
+            pros::Task::delay_until(now, delay_ms);
+            break;
+    }
+}
+
+std::int32_t umbc::VController::is_playing() {
+
+    this->t_update_mutex.take(TIMEOUT_MAX);
+    std::int32_t playing = this->is_update_running();
+    this->t_update_mutex.give();
+
+    return playing;
+}
+
+std::int32_t umbc::VController::is_update_running() {
+
+    Task* t_update = this->t_update_controller_input.get();
+
+    return (nullptr == t_update) ? 0
+        : ((t_update->get_state() != E_TASK_STATE_INVALID) && (t_update->get_state() != E_TASK_STATE_DELETED));
+}
+
+void umbc::VController::notify_update() {
+
+    this->t_update_mutex.take(TIMEOUT_MAX);
+    if (this->is_update_running()) {
+        this->t_update_controller_input->notify();
+    }
+    this->t_update_mutex.give();
+}
+
+ControllerInput umbc::VController::jump(std::uint32_t time_ms) {
+
+    Recording* recording = this->recording.get();
+    std::uint32_t number_of_frames = recording->size();
+
+    if (time_ms >= recording->get_duration()) {
+        this->controller_input_index = number_of_frames;
+        return ControllerInput();
+    }
 
-    while (!controller->controller_input.empty()) {
+    std::uint32_t event = recording->find_event_at(time_ms);
+    std::uint32_t event_frame = recording->get_event_frame(event);
+    std::uint32_t event_end = (event + 1 < recording->get_number_of_events())
+        ? recording->get_event_frame(event + 1) : number_of_frames;
+    std::uint32_t frame = event_frame + (time_ms - recording->get_time(event_frame, event)) / recording->get_poll_rate();
 
-        pros::Task::delay_until(&now, controller->poll_rate_ms);
-        controller->controller_input.pop();
+    this->controller_input_event = event;
+    this->controller_input_index = (frame < event_end) ? frame : event_end - 1;
 
-        for (auto it = controller->digitals.begin(); it != controller->digitals.end(); it++) {
-            it->second.set(controller->controller_input.front().get_digital(it->first));
+    return recording->get_event(event);
+}
+
+void umbc::VController::resample(std::uint32_t time_ms, ControllerInput& controller_input) {
+
+    Recording* recording = this->recording.get();
+    std::uint32_t number_of_frames = recording->size();
+    std::uint32_t number_of_events = recording->get_number_of_events();
+    std::uint16_t recording_poll_rate_ms = recording->get_poll_rate();
+    std::uint32_t index = this->controller_input_index;
+    std::uint32_t event = this->controller_input_event;
+
+    // find the last event and frame at or before time_ms, frames within an
+    // event are exactly one recording poll rate apart
+    while (event + 1 < number_of_events
+        && time_ms >= recording->get_time(recording->get_event_frame(event + 1), event + 1)) {
+        event++;
+    }
+
+    std::uint32_t event_frame = recording->get_event_frame(event);
+    std::uint32_t event_end = (event + 1 < number_of_events) ? recording->get_event_frame(event + 1) : number_of_frames;
+    std::uint32_t frame = event_frame + (time_ms - recording->get_time(event_frame, event)) / recording_poll_rate_ms;
+    index = (index > frame) ? index : frame;
+    index = (index < event_end) ? index : event_end - 1;
+
+    std::uint32_t time = recording->get_time(index, event);
+    const ControllerInput& before = recording->get_event(event);
+
+    if (index + 1 == number_of_frames) {
+        // the last frame is held for one recording poll rate
+        this->controller_input_event = event;
+        if (time_ms < time + recording_poll_rate_ms) {
+            controller_input = before;
+        } else {
+            controller_input = ControllerInput();
+            index = number_of_frames;
         }
+        this->controller_input_index = index;
+        return;
     }
 
-    for (auto it = controller->digitals.begin(); it != controller->digitals.end(); it++) {
-        it->second.reset();
+    std::uint32_t next_event = (index + 1 == event_end) ? event + 1 : event;
+    const ControllerInput& after = recording->get_event(next_event);
+    std::int32_t span = recording->get_time(index + 1, next_event) - time;
+    std::int32_t elapsed = time_ms - time;
+
+    std::int8_t axes[ControllerInput::number_of_analogs];
+    for (std::uint32_t i = 0; i < ControllerInput::number_of_analogs; i++) {
+        std::int32_t delta = (after.axes()[i] - before.axes()[i]) * elapsed;
+        axes[i] = before.axes()[i] + (2 * delta + ((0 > delta) ? -span : span)) / (2 * span);
     }
+
+    controller_input.set_all((2 * elapsed < span) ? before.buttons() : after.buttons(), axes);
+    this->controller_input_event = event;
+    this->controller_input_index = index;
 }
 
 std::int32_t umbc::VController::is_connected() {
-    return !this->controller_input.empty();
+    return this->controller_input_index < this->recording->size();
 }
 
 std::int32_t umbc::VController::get_analog(controller_analog_e_t channel) {
-    return this->controller_input.empty() ? 0 : this->controller_input.front().get_analog(channel);
+
+    return this->controller_input.load().get_analog(channel);
 }
 
 std::int32_t umbc::VController::get_battery_capacity() {
@@ -81,13 +280,17 @@ std::int32_t umbc::VController::get_battery_level() {
 }
 
 std::int32_t umbc::VController::get_digital(controller_digital_e_t button) {
-    return this->controller_input.empty() ? 0 : this->controller_input.front().get_digital(button);
+
+    return this->controller_input.load().get_digital(button);
 }
 
 std::int32_t umbc::VController::get_digital_new_press(controller_digital_e_t button) {
+    return this->digital_edges.get_new_press(button);
+}
+
+ControllerInput umbc::VController::snapshot() {
 
-    std::map<controller_digital_e_t, Digital>::iterator digital = this->digitals.find(button);
-    return (digital == this->digitals.end()) ? 0 : digital->second.get_new_press();
+    return this->controller_input.load();
 }
 
 template <typename... Params> std::int32_t umbc::VController::print(std::uint8_t line, std::uint8_t col, const char* fmt, Params... args) {
@@ -116,59 +319,112 @@ std::int32_t umbc::VController::clear() {
 
 std::int32_t umbc::VController::load(const char* file_path) {
 
-    this->controller_input = std::queue<ControllerInput>();
-
-    string file_path_str = string(file_path);
+    std::shared_ptr<Recording> recording = std::make_shared<Recording>();
 
-    std::ifstream file(file_path, std::ifstream::binary);
-    if (!file.good()) {
-        file.close();
-        ERROR("could not open " + file_path_str);
+    if (!recording->load(file_path)) {
+        this->recording = std::make_shared<Recording>();
+        this->controller_input_index = 0;
+        this->controller_input_event = 0;
+        this->controller_input.store(ControllerInput());
+        this->position_ms = 0;
+        this->seek_ms = -1;
         return 0;
     }
 
-    INFO("reading poll rate from " + file_path_str + "...");
-    file.read((char*)(&(this->poll_rate_ms)), sizeof(this->poll_rate_ms));
-    if (!file.good() || 0 == this->poll_rate_ms) {
-        this->poll_rate_ms = 0;
-        file.close();
-        ERROR("failed to read poll rate from " + file_path_str);
-        return 0;
-    }
-    INFO("poll rate is " + std::to_string(this->poll_rate_ms) + "ms");
+    return this->load(recording);
+}
 
-    INFO("loading in controller data from " + file_path_str + "...");
-    while(1) {
+std::int32_t umbc::VController::load(std::string& file_path) {
+    return this->load(file_path.c_str());
+}
 
-        ControllerInput controller_input;
-        file.read((char*)(&controller_input), sizeof(controller_input)); 
+std::int32_t umbc::VController::load(std::shared_ptr<Recording> recording) {
 
-        if (file.eof()) {
-            break;
-        } else if (!file.good()) {
-            this->poll_rate_ms = 0;
-            this->controller_input = std::queue<ControllerInput>();
-            file.close();
-            ERROR("failed to read controller data from " + file_path_str);
-            return 0;
-        }
-        this->controller_input.push(controller_input);
+    this->controller_input_index = 0;
+    this->controller_input_event = 0;
+    this->controller_input.store(ControllerInput());
+    this->position_ms = 0;
+    this->seek_ms = -1;
+
+    if (nullptr == recording.get() || 0 == recording->size()) {
+        this->recording = std::make_shared<Recording>();
+        ERROR("no controller input to load");
+        return 0;
     }
-    INFO("controller data from " + file_path_str + " loaded successfully");
 
-    file.close();
+    this->recording = recording;
+    this->controller_input.store(recording->get_event(0));
     return 1;
 }
 
-std::int32_t umbc::VController::load(std::string& file_path) {
-    return this->load(file_path.c_str());
-}
-
 void umbc::VController::start() {
 
+    this->ticks = 0;
+    this->steps = 0;
+    this->loop_timing.reset((0 != this->poll_rate_ms) ? this->poll_rate_ms : this->recording->get_poll_rate());
+
+    this->t_update_mutex.take(TIMEOUT_MAX);
     this->t_update_controller_input.reset(
         new Task((task_fn_t)this->update, (void*)this, this->t_update_controller_input_name));
-    INFO(string(t_update_controller_input_name) + " has started");
+    this->t_update_mutex.give();
+    DEBUG("%s has started", t_update_controller_input_name);
+}
+
+void umbc::VController::seek(std::uint32_t position_ms) {
+
+    if (INT32_MAX < position_ms) {
+        position_ms = INT32_MAX;
+    }
+
+    if (!this->is_playing()) {
+        this->position_ms = position_ms;
+        this->controller_input.store(this->jump(position_ms));
+    } else {
+        this->seek_ms = position_ms;
+    }
+    DEBUG("seeking to %ums", position_ms);
+}
+
+std::uint32_t umbc::VController::get_position() {
+    return this->position_ms;
+}
+
+void umbc::VController::set_speed(float speed) {
+
+    if (0 >= speed) {
+        WARN("invalid playback speed %g", speed);
+        return;
+    }
+    this->speed = speed;
+}
+
+void umbc::VController::set_loop(std::uint32_t start_ms, std::uint32_t end_ms) {
+
+    this->loop_ms = ((std::uint64_t)start_ms << 32) | end_ms;
+}
+
+void umbc::VController::set_policy(playback_policy policy, std::uint32_t max_lead) {
+
+    this->max_lead = max_lead;
+    this->policy = policy;
+
+    // wake playback in case it is waiting under the old policy
+    this->notify_update();
+}
+
+void umbc::VController::set_correction(std::shared_ptr<PoseCorrection> correction) {
+
+    if (this->is_playing()) {
+        WARN("pose correction can not be changed during playback");
+        return;
+    }
+    this->correction = correction;
+}
+
+void umbc::VController::tick() {
+
+    this->ticks++;
+    this->notify_update();
 }
 
 void umbc::VController::pause() {
@@ -178,9 +434,9 @@ void umbc::VController::pause() {
     if (nullptr != t_update) {
         try {
             t_update->suspend();
-            INFO(string(t_update_controller_input_name) + " is paused");
+            DEBUG("%s is paused", t_update_controller_input_name);
         } catch (...) {
-            ERROR("failed to pause " + string(t_update_controller_input_name));
+            ERROR("failed to pause %s", t_update_controller_input_name);
         }
     }
 }
@@ -191,29 +447,40 @@ void umbc::VController::resume() {
 
     if (nullptr != t_update) {
         try {
+            this->resumed = 1;
             t_update->resume();
-            INFO(string(t_update_controller_input_name) + " has resumed");
+            DEBUG("%s has resumed", t_update_controller_input_name);
         } catch (...) {
-            ERROR("failed to resume " + string(t_update_controller_input_name));
+            ERROR("failed to resume %s", t_update_controller_input_name);
         }
     }
 }
 
 void umbc::VController::stop() {
 
+    this->t_update_mutex.take(TIMEOUT_MAX);
+
     Task* t_update = this->t_update_controller_input.get();
 
     if (nullptr != t_update) {
         try {
             t_update->remove();
-            INFO(string(t_update_controller_input_name) + " is stopped");
+            DEBUG("%s is stopped", t_update_controller_input_name);
         } catch (...) {
-            ERROR("failed to stop " + string(t_update_controller_input_name));
+            ERROR("failed to stop %s", t_update_controller_input_name);
         }
     }
 
-    this->controller_input = std::queue<ControllerInput>();
-    INFO("virtual controller input queue is cleared");
+    this->t_update_mutex.give();
+
+    this->recording = std::make_shared<Recording>();
+    this->controller_input_index = 0;
+    this->controller_input_event = 0;
+    this->controller_input.store(ControllerInput());
+    this->position_ms = 0;
+    this->seek_ms = -1;
+    this->correction = nullptr;
+    INFO("virtual controller input buffer is cleared");
 }
 
 void umbc::VController::wait_till_complete() {
@@ -223,38 +490,13 @@ void umbc::VController::wait_till_complete() {
     if (nullptr != t_update) {
         try {
             t_update->join();
-            INFO(string(t_update_controller_input_name) + " has completed");
+            DEBUG("%s has completed", t_update_controller_input_name);
         } catch (...) {
-            ERROR("failed to complete " + string(t_update_controller_input_name));
+            ERROR("failed to complete %s", t_update_controller_input_name);
         }
     }
 }
 
-umbc::VController::Digital::Digital(){
-    this->reset();
+LoopTiming& umbc::VController::get_loop_timing() {
+    return this->loop_timing;
 }
-
-void umbc::VController::Digital::set(std::int32_t value) {
-
-    this->previous = this->current;
-    this->current = value;
-    this->newPress = this->newPress || (this->current && !this->previous);
-}
-
-void umbc::VController::Digital::reset() {
-
-    this->current = 0;
-    this->previous = 0;
-    this->newPress = 0;
-}
-
-std::int32_t umbc::VController::Digital::get() {
-    return this->current;
-}
-
-std::int32_t umbc::VController::Digital::get_new_press() {
-
-    int32_t newPress = this->newPress;
-    this->newPress = 0;
-    return newPress;
-}
\ No newline at end of file